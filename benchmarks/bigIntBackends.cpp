@@ -0,0 +1,105 @@
+// Times Hensel factorization and the modular gcd with the backend of big_int
+//  chosen when building (CMake option ALCP_BIG_INT), and products and gcds
+//  with coefficients of about 100 bits.
+//  bigIntBackends.sh builds and runs it with every backend.
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "types.hpp"
+#include "hybridInt.hpp"
+#include "zxelem.hpp"
+#include "hensel.hpp"
+#include "modularGCD.hpp"
+
+using namespace alcp;
+
+namespace {
+    Zxelem_b randomPol(std::mt19937 &gen, std::size_t deg, int bound) {
+        std::uniform_int_distribution<int> distr(-bound, bound);
+        std::vector<big_int> v(deg + 1);
+        for (auto &coef : v)
+            coef = distr(gen);
+        v[deg] = 1 + std::abs(distr(gen)) % 3;
+        return v;
+    }
+
+    // Coefficients of about 100 bits do not fit in a long long or an __int128,
+    //  so with those backends they are stored as a HybridInt, which promotes
+    //  to cpp_int. The products are long enough to use Kronecker substitution
+    using Large = std::conditional_t<bmp::is_number<big_int>::value, big_int, HybridInt>;
+
+    Zxelem<Large> randomLargePol(std::mt19937_64 &gen, std::size_t deg) {
+        std::vector<Large> v(deg + 1);
+        for (auto &coef : v) {
+            bmp::cpp_int c = gen() >> 28;
+            c = (c << 64) + gen();
+            coef = Large(gen() % 2 ? c : bmp::cpp_int(-c));
+        }
+        return v;
+    }
+
+    template<class F>
+    double timeMs(F f, int reps) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; ++i)
+            f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / reps;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const int reps = argc > 1 ? std::atoi(argv[1]) : 5;
+    std::mt19937 gen(2017);
+
+    // Products of three polynomials with small coefficients, so the bounds
+    //  of the lifting also fit in a long long
+    std::vector<Zxelem_b> toFactor;
+    for (int i = 0; i < 4; ++i)
+        toFactor.push_back(randomPol(gen, 3, 9) * randomPol(gen, 3, 9) * randomPol(gen, 2, 9));
+
+    std::vector<std::pair<Zxelem_b, Zxelem_b>> toGcd;
+    for (int i = 0; i < 4; ++i) {
+        Zxelem_b g = randomPol(gen, 4, 50);
+        toGcd.emplace_back(g * randomPol(gen, 6, 50), g * randomPol(gen, 5, 50));
+    }
+
+    std::mt19937_64 gen64(2017);
+    std::vector<std::pair<Zxelem<Large>, Zxelem<Large>>> toMulLarge;
+    for (int i = 0; i < 4; ++i)
+        toMulLarge.emplace_back(randomLargePol(gen64, 63), randomLargePol(gen64, 63));
+
+    std::vector<std::pair<Zxelem<Large>, Zxelem<Large>>> toGcdLarge;
+    for (int i = 0; i < 2; ++i) {
+        Zxelem<Large> g = randomLargePol(gen64, 3);
+        toGcdLarge.emplace_back(g * randomLargePol(gen64, 4), g * randomLargePol(gen64, 3));
+    }
+
+    std::size_t checksum = 0;
+    double hensel = timeMs([&]() {
+        for (const auto &pol : toFactor)
+            checksum += factorizationHensel(pol).size();
+    }, reps);
+    double gcd = timeMs([&]() {
+        for (const auto &pair : toGcd)
+            checksum += modularGCD(pair.first, pair.second).deg();
+    }, reps);
+
+    double mulLarge = timeMs([&]() {
+        for (const auto &pair : toMulLarge)
+            checksum += (pair.first * pair.second).deg();
+    }, reps);
+    double gcdLarge = timeMs([&]() {
+        for (const auto &pair : toGcdLarge)
+            checksum += modularGCD(pair.first, pair.second).deg();
+    }, reps);
+
+    std::cout << bigIntBackend << "\thensel: " << hensel << " ms\tmodularGCD: " << gcd << " ms"
+              << "\t" << (std::is_same<Large, big_int>::value ? "big_int" : "HybridInt")
+              << " with 100 bits, product: " << mulLarge << " ms\tmodularGCD: " << gcdLarge << " ms"
+              << "\t(checksum " << checksum << ")" << std::endl;
+}
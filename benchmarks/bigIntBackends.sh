@@ -0,0 +1,14 @@
+#!/bin/sh
+# Builds the library with every backend of big_int and compares them on
+#  Hensel factorization and the modular gcd, and on products and gcds with
+#  large coefficients.
+# Usage: benchmarks/bigIntBackends.sh [repetitions]
+set -e
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+for backend in long_long int128 cpp_int gmp; do
+    dir="$ROOT/build-bench-$backend"
+    mkdir -p "$dir"
+    (cd "$dir" && cmake "$ROOT" -DCMAKE_BUILD_TYPE=Release -DALCP_BIG_INT=$backend > /dev/null 2>&1)
+    cmake --build "$dir" --target alcp_bench_bigint -- -j4 > /dev/null
+    "$dir/benchmarks/alcp_bench_bigint" "$@"
+done
@@ -0,0 +1,128 @@
+// Measures on this machine the Karatsuba threshold that makes the products of
+//  polynomials fastest, for every ring that specializes KaratsubaThreshold, and
+//  prints the values to use.
+// Usage: alcp_tune_karatsuba [largest number of coefficients of the factors, 512 by default]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+#include "zxelem.hpp"
+#include "fpxelem.hpp"
+#include "fqxelem.hpp"
+#include "factorizationFq.hpp"
+#include "hybridInt.hpp"
+
+using namespace alcp;
+
+namespace {
+    // Sum of the degrees of the products, printed so they are not optimized away
+    std::size_t checksum = 0;
+
+    // Time of one call to f, from enough repetitions to take about 1 ms
+    template<class F>
+    double timeNs(F f) {
+        for (int reps = 1;; reps *= 2) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < reps; ++i)
+                f();
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed.count() > 1e6)
+                return elapsed.count() / reps;
+        }
+    }
+
+    // The threshold that makes the products of n/8, n/4, n/2 and n coefficients
+    //  fastest, adding their times relative to the schoolbook product.
+    //  karatsuba::none if no threshold beats the schoolbook product
+    template<class Fxelem, class Random>
+    std::size_t bestThreshold(Random random, std::size_t n) {
+        std::vector<std::size_t> thresholds{karatsuba::none};
+        for (std::size_t t = 4; t <= n; t += t < 32 ? 2 : t / 8)
+            thresholds.push_back(t);
+        std::vector<std::pair<Fxelem, Fxelem>> factors;
+        for (std::size_t size = n / 8; size <= n; size *= 2)
+            factors.emplace_back(random(size), random(size));
+
+        // The minimum of several rounds filters out the noise of other processes
+        const int rounds = 5;
+        std::vector<std::vector<double>> time(thresholds.size(),
+                                              std::vector<double>(factors.size(), std::numeric_limits<double>::max()));
+        for (int round = 0; round < rounds; ++round)
+            for (std::size_t i = 0; i < thresholds.size(); ++i)
+                for (std::size_t j = 0; j < factors.size(); ++j)
+                    time[i][j] = std::min(time[i][j], timeNs([&]() {
+                        checksum += Fxelem::mul(factors[j].first, factors[j].second, thresholds[i]).deg();
+                    }));
+
+        std::size_t best = 0;
+        double bestScore = static_cast<double>(factors.size());
+        for (std::size_t i = 1; i < thresholds.size(); ++i) {
+            double score = 0;
+            for (std::size_t j = 0; j < factors.size(); ++j)
+                score += time[i][j] / time[0][j];
+            if (score < bestScore) {
+                best = i;
+                bestScore = score;
+            }
+        }
+        return thresholds[best];
+    }
+
+    template<template <class> class FxelemBase>
+    void print(const std::string &ring, const std::string &description, std::size_t measured) {
+        std::cout << "KaratsubaThreshold<" << ring << ">::value = "
+                  << (measured == karatsuba::none ? "karatsuba::none" : std::to_string(measured))
+                  << "\t(now " << KaratsubaThreshold<FxelemBase>::value << ", " << description << ")" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512;
+    std::mt19937 gen(2017);
+
+    const Fp_b fp(2147483647);
+    print<Fpxelem>("Fpxelem", "p = 2^31 - 1", bestThreshold<Fpxelem_b>([&](std::size_t size) {
+        return randomPol(fp, size - 1);
+    }, n));
+
+    // Fqxelem multiplies with Kronecker substitution from kroneckerThreshold
+    //  coefficients on, unless the field uses Zech logarithms, so the Karatsuba
+    //  threshold is measured with them
+    for (const auto &q : std::vector<std::pair<long long, std::size_t>>{{2, 8}, {251, 2}}) {
+        const Fq_b fq(q.first, q.second, FqRepresentation::zech);
+        print<Fqxelem>("Fqxelem", "q = " + std::to_string(q.first) + "^" + std::to_string(q.second) +
+                                  " with Zech logarithms", bestThreshold<Fqxelem_b>([&](std::size_t size) {
+            return randomPol(fq, size - 1);
+        }, n));
+    }
+
+    // With big_int = cpp_int or gmp, and with HybridInt coefficients of 63
+    //  bits or more, Zxelem multiplies dense factors of kroneckerThreshold
+    //  coefficients or more with Kronecker substitution, so the Karatsuba
+    //  threshold is measured with the coefficients whose products stay in it
+    std::uniform_int_distribution<int> distr(-(1 << 20), 1 << 20);
+    const auto randomZx = [&](auto zero) {
+        return [&gen, &distr, zero](std::size_t size) {
+            std::vector<decltype(zero)> v(size);
+            for (auto &coef : v)
+                coef = distr(gen);
+            v.back() = 1;
+            return Zxelem<decltype(zero)>(v);
+        };
+    };
+    const std::string zxNote = "; it applies to long long, to HybridInt below 63 bits and to sparse "
+                               "factors with big_int = " + std::string(bigIntBackend);
+    print<Zxelem>("Zxelem", "coefficients of 20 bits in a long long" + zxNote,
+                  bestThreshold<Zxelem<long long>>(randomZx(0LL), n));
+    print<Zxelem>("Zxelem", "coefficients of 20 bits in a HybridInt" + zxNote,
+                  bestThreshold<Zxelem<HybridInt>>(randomZx(HybridInt(0)), n));
+
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+}
@@ -0,0 +1,94 @@
+#ifndef __ACCUMULATOR_HPP
+#define __ACCUMULATOR_HPP
+
+#include <cstdint>      // std::uint64_t
+#include <type_traits>  // std::enable_if_t
+#include <utility>      // std::declval
+
+#include "modArith.hpp" // uint128_t, reduceWideMod
+
+namespace alcp {
+    /**
+     * Accumulator of sums of products
+     *
+     * Description:
+     *  Computes expressions of the form c + sum a_i*b_i. The generic version
+     *   just uses the ring operations of Felem.
+     *  Use it as
+     *   Accumulator<Felem> acc(c); // c is the initial value, e.g. getZero(e)
+     *   acc.addProduct(a, b);
+     *   ...
+     *   Felem res = acc.get();
+     */
+    template<class Felem, class = void>
+    class Accumulator {
+    public:
+        explicit Accumulator(const Felem &init) : _sum(init) { }
+
+        void add(const Felem &a) { _sum += a; }
+
+        void addProduct(const Felem &a, const Felem &b) { _sum += a * b; }
+
+        void subProduct(const Felem &a, const Felem &b) { _sum -= a * b; }
+
+        Felem get() const { return _sum; }
+
+    private:
+        Felem _sum;
+    };
+
+    /**
+     * Lazy reduction for elements of Z/pZ stored in a machine word
+     *
+     * Description:
+     *  The products of the residues are added unreduced in a 128-bit integer
+     *   and the sum is reduced once, when get() is called, instead of
+     *   reducing after every multiplication and every addition.
+     *  Every product is smaller than p^2 < 2^126, so if the sum is folded
+     *   (reduced) whenever it reaches 2^127 it never overflows. For p < 2^32
+     *   this never happens in practice.
+     *  It is selected for every Felem whose modulus supports reduceWideMod,
+     *   i.e. Fpelem over a built-in integer and StaticFpelem.
+     */
+    template<class Felem>
+    class Accumulator<Felem, decltype(static_cast<void>(reduceWideMod(
+            std::declval<uint128_t>(), std::declval<const typename Felem::ModulusType &>())))> {
+    public:
+        explicit Accumulator(const Felem &init) : _elem(init), _sum(static_cast<std::uint64_t>(init._num)) { }
+
+        void add(const Felem &a) {
+            _sum += static_cast<std::uint64_t>(a._num);
+            fold();
+        }
+
+        void addProduct(const Felem &a, const Felem &b) {
+            _sum += static_cast<uint128_t>(static_cast<std::uint64_t>(a._num)) * static_cast<std::uint64_t>(b._num);
+            fold();
+        }
+
+        // -a*b = a*(p-b) (mod p), which is again a sum of positive residues
+        void subProduct(const Felem &a, const Felem &b) {
+            _sum += static_cast<uint128_t>(static_cast<std::uint64_t>(a._num)) *
+                    static_cast<std::uint64_t>(negMod(b._num, _elem.mod()));
+            fold();
+        }
+
+        Felem get() const {
+            Felem ret(_elem);
+            ret._num = reduceWideMod(_sum, _elem.mod());
+            return ret;
+        }
+
+    private:
+        void fold() {
+            if (_sum >> 127)
+                _sum = static_cast<uint128_t>(reduceWideMod(_sum, _elem.mod()));
+        }
+
+        // Any element of the field, used to build the result
+        Felem _elem;
+        uint128_t _sum;
+    };
+}
+
+#endif // __ACCUMULATOR_HPP
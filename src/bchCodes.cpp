@@ -1,6 +1,7 @@
 #include "bchCodes.hpp"
 
 #include <vector>
+#include <algorithm>
 #include <utility>
 #include <random>
 #include <chrono>
@@ -10,12 +11,16 @@
 #include <unordered_map>
 
 #include "berlekampMassey.hpp"
+#include "diskCache.hpp"
 #include "generalPurpose.hpp"
 #include "types.hpp"
 #include "fpelem.hpp"
 #include "fpxelem.hpp"
 #include "fqelem.hpp"
 #include "fqxelem.hpp"
+#include "f2melem.hpp"
+#include "f2mxelem.hpp"
+#include "preparedMultiplier.hpp"
 
 namespace alcp {
 	std::pair<std::set<int>, Fpxelem_b > BCH::randomErrors(Fpxelem_b v){
@@ -61,58 +66,54 @@ namespace alcp {
 			return false;
 	}
 	/* This solves the linear system Ax = b for a non singular square matrix with no zeros in the main diagonal
+	 * The elimination is fraction free (row_j = m[i][i]*row_j - m[j][i]*row_i), so the only inverses needed are
+	 * those of the diagonal of the final triangular system, which are computed together with batchInvert
 	 */
-	std::vector<Fqelem_b> solve(std::vector<std::vector<Fqelem_b> > &m, std::vector<Fqelem_b> & b) {
+	template<class Felem>
+	std::vector<Felem> solve(std::vector<std::vector<Felem> > &m, std::vector<Felem> & b) {
 		int i, j, k, rows = m.size(), cols = rows;
-		Fqelem_b c;
 		for (i = 0; i < rows; i++) {
-			b[i] /= m[i][i];
-			for (j = cols-1; j >= 0; j--)
-				m[i][j] /= m[i][i];
 			for (j = i+1; j < rows; j++){
-				b[j] -= b[i] * m[j][i];
+				Felem factor = m[j][i];
+				b[j] = b[j] * m[i][i] - b[i] * factor;
 				for(k = cols-1; k >= i; --k){
-					m[j][k] -= m[i][k] * m[j][i];
+					m[j][k] = m[j][k] * m[i][i] - m[i][k] * factor;
 				}
 			}
 		}//Gauss finished
-		//Now solve triangular system with 1's in the main diagonal (now it is not necessary to edit the matrix)
+		std::vector<Felem> diagInv(rows);
+		for (i = 0; i < rows; i++)
+			diagInv[i] = m[i][i];
+		batchInvert(diagInv);
+		//Now solve the triangular system
 		for (j = cols-1; j >= 0; --j){
-			for(i = j-1; i >= 0 ; --i)
-				b[i] -= b[j] * m[i][j];
+			for(k = j+1; k < cols; ++k)
+				b[j] -= m[j][k] * b[k];
+			b[j] *= diagInv[j];
 		}
 		return b;
 	}
 
-	Fpxelem_b generating_polynomial(const Fqelem_b & alpha, size_t c, size_t d, const big_int & q){
-		std::set<Fqelem_b>  rootSet;
-		Fqelem_b root = fastPow(alpha, c);
+	// The roots of the minimum polynomials are the images of alpha^i by the Frobenius map x -> x^q, q = p^n.
+	// Every conjugacy class contributes its minimal polynomial over F_p, which is the case n = 1
+	template<class Felem>
+	Fpxelem_b generating_polynomial(const Felem & alpha, size_t c, size_t d, size_t n){
+		std::set<Felem>  rootSet;
+		const PreparedMultiplier<Felem> byAlpha(alpha);
+		Felem root = fastPow(alpha, c);
+		Fpxelem_b result(alpha.getField().getBaseField().one());
 		for (size_t i = 0; i <= d-2; i++){//d is always >= 2
-			if (rootSet.find(root) != rootSet.end()){ //Continue if the root was already processed
-				root *= alpha;
-				continue;
+			if (rootSet.find(root) == rootSet.end()){ //Skip the roots that were already processed
+				Felem aux = root;
+				do{
+					rootSet.insert(aux);
+					aux = frobenius(aux, n); //Frobenius automorphism
+				}while(root != aux);
+				result *= minpoly(root);
 			}
-			Fqelem_b aux = root;
-			do{
-				rootSet.insert(aux);
-				aux = fastPow(aux, q ); //Frobenius automorphism
-			}while(root != aux);
-			root *= alpha;
+			root = byAlpha.mul(root);
 		}
-		std::vector<Fqelem_b> monomial(2, getZero(alpha));
-		monomial[0] = getOne(alpha);
-		Fqxelem_b result(monomial);
-		monomial[1] = getOne(alpha);
-		for(auto & r : rootSet){
-			monomial[0] = -r;
-			result *= Fqxelem_b(monomial);
-		}
-		//The result's coefficients are in Fp
-		std::vector<Fpelem_b> vec(result.deg()+1);
-		for(unsigned int i = 0; i <= result.deg(); i++ ){
-			vec[i] = static_cast<Fpxelem_b>(result[i])[0]; //coger el elemento de Fp de este elemento de Fq
-		}
-		return Fpxelem_b(vec);
+		return result;
 	}
 
 	/* Precondition: primitive_poly must be a primitive polynomial over a finite field with p elements, with p prime.
@@ -133,8 +134,26 @@ namespace alcp {
 	 *
 	 * Note that without any generalization we always have n = 1. Right now the method is implemented for n = 1.
 	 * */
+	// Whether g, read from diskCache, can generate a cyclic code of length l: deg(g) < l and g | x^l - 1
+	bool isCyclicGenerator(const Fpxelem_b &g, size_t l){
+		if (g == 0 || g.deg() >= l)
+			return false;
+		std::vector<Fpelem_b> xl(l+1, getZero(g.lc()));
+		xl[0] = -getOne(g.lc());
+		xl[l] = getOne(g.lc());
+		return Fpxelem_b(xl) % g == 0;
+	}
+
+	// Small extensions, which include every example, are stored with Zech logarithms. Binary
+	//  codes compute in F2m instead, so their Fq is not used
+	FqRepresentation representationFor(const Fpxelem_b &f){
+		if (f.getSize() != 2 && FqContext<big_int>::zechAvailable(f.getSize(), f.deg()))
+			return FqRepresentation::zech;
+		return FqRepresentation::residues;
+	}
+
 	BCH::BCH(const Fpxelem_b &primitive_poly, size_t n, size_t l, size_t cc, size_t d):
-		field_ext(primitive_poly){
+		field_ext(primitive_poly, representationFor(primitive_poly)){
 		//if (primitive_poly.deg() % n != 0)
 		//	throw EBadBCHInitialization("The degree of the primitive polynomial is not coherent.");
 		this->c = cc;
@@ -147,8 +166,31 @@ namespace alcp {
 		std::vector<Fpelem_b> aux(2, getZero(primitive_poly[0])); //gen
 		aux[1] = 1;
 		Fpxelem_b aux2 = Fpxelem_b(aux);
-		alpha = field_ext.get(fastPow(aux2, (fastPow(q, m)-1)/l )); // alpha := x^{(q^m-1)/l} \in F_{p^{mn}}
-		g = generating_polynomial(alpha, c, d, q); //Esto en el ordenador va a estar como un polinomio sobre F_{q^m} pero
+		binary = p == 2;
+		if (binary)
+			binaryAlpha = fastPow(F2m_b(primitive_poly).get(aux2), (fastPow(q, m)-1)/l);
+		else
+			alpha = field_ext.get(fastPow(aux2, (fastPow(q, m)-1)/l )); // alpha := x^{(q^m-1)/l} \in F_{p^{mn}}
+		// The generator is read from diskCache if it is there, and stored in it otherwise
+		std::vector<std::uint32_t> key, payload;
+		diskCache::putPolynomial(key, primitive_poly);
+		for (size_t param : {n, l, c, d})
+			diskCache::put(key, param);
+		bool cached = false;
+		diskCache::Entry entry;
+		if (diskCache::load("bch", key, entry)) {
+			diskCache::Reader reader(entry);
+			cached = reader.getPolynomial(g, primitive_poly[0].getField()) && reader.done() && isCyclicGenerator(g, l);
+		}
+		if (!cached) {
+			g = binary ? generating_polynomial(binaryAlpha, c, d, n) : generating_polynomial(alpha, c, d, n);
+			if (diskCache::enabled()) {
+				payload.clear();
+				diskCache::putPolynomial(payload, g);
+				diskCache::store("bch", key, payload);
+			}
+		}
+		//Esto en el ordenador va a estar como un polinomio sobre F_{q^m} pero
 														//sus coeficientes van a estar en realidad sobre F_q (q podría ser p en este momento)
 		//g always divides x^l-1, we don't have to take module x^l-1
 		dimension = l - g.deg()-1;
@@ -162,26 +204,38 @@ namespace alcp {
 		if(message.deg()+1 > dimension)
 			throw EBadFormatMessageBCH("The message is too long.");
 
+		// Binary codes are multiplied as packed bits
+		if (g.getSize() == 2)
+			return static_cast<Fpxelem_b>(F2xelem(g) * F2xelem(message));
 		return g*message;
 	}
 
 	Fpxelem_b BCH::decode(Fpxelem_b w){
+		if (binary)
+			return decodeWith<F2mxelem_b>(binaryAlpha, w);
+		return decodeWith<Fqxelem_b>(alpha, w);
+	}
+
+	template<class Fxelem>
+	Fpxelem_b BCH::decodeWith(const typename Fxelem::Felem &alpha, Fpxelem_b w) const {
+		using Felem = typename Fxelem::Felem;
 		std::cout << std::endl << std::endl << "Decoding. Computing syndromes." << std::endl;
-		std::vector<Fqelem_b> syndromes(distance-1);
-		Fqelem_b aux = fastPow(alpha, c);
+		std::vector<Felem> syndromes(distance-1);
+		const PreparedMultiplier<Felem> byAlpha(alpha);
+		Felem aux = fastPow(alpha, c);
 		//inmersión de w en el anillo de polinomios de la extension F_q
-		std::vector<Fpxelem_b> inter(w.deg()+1);
+		const auto field = alpha.getField();
+		std::vector<Felem> inter(w.deg()+1);
 		for( size_t i = 0; i<= w.deg(); i++){
-			inter[i] = Fpxelem_b(w[i]);
+			inter[i] = field.get(Fpxelem_b(w[i]));
 		}
-		Fqxelem_b ww = Fqxelem_b(inter, field_ext); //This is the natural inmersion of w \in F_p to ww \in F_q
-		//Fqxelem_b ww = toFqxelem(inter, field_ext); //This is the natural inmersion of w \in F_p to ww \in F_q
+		Fxelem ww = Fxelem(inter); //This is the natural inmersion of w \in F_p to ww \in F_q
 		for (size_t i = 0; i <= distance-2; i++ ){
 			syndromes[i] = ww.eval(aux);
-			aux *= alpha;
+			aux = byAlpha.mul(aux);
 		}
 		std::cout << "Decoding using Berlekamp algorithm."<< std::endl;
-		Fqxelem_b errorLocatorPoly = berlekampMassey<Fqxelem_b>(syndromes);
+		Fxelem errorLocatorPoly = berlekampMassey<Fxelem>(syndromes);
 		std::cout << "Berlekamp finished, computing the roots indices."<< std::endl;
 		//std::cout << "errorLocatorPoly " << errorLocatorPoly << std::endl;
 		unsigned int nErrors = errorLocatorPoly.deg();
@@ -189,24 +243,24 @@ namespace alcp {
 			throw ETooManyErrorsBCH("Too many errors");
 
 		size_t i = 0, index = 1;
-		Fqelem_b aux2 = alpha;
+		Felem aux2 = alpha;
 		std::vector<int> pos_errors(nErrors);
 		while (i != nErrors && index <= length){
 			if (errorLocatorPoly.eval(aux2) == 0){
 				pos_errors[i++] = length - index; //This is because we work with the reciprocal polynomial
 			}
 			index++;
-			aux2 *= alpha;
+			aux2 = byAlpha.mul(aux2);
 		}
 		std::cout << nErrors <<  " error/s has/have been detected at index/indices ";
 		for (auto &elem : pos_errors){
 			std::cout << elem << ", ";
 		}
 		std::cout << std::endl;
-		std::vector<std::vector<Fqelem_b> > m(nErrors, std::vector<Fqelem_b>(nErrors));
-		std::vector<Fqelem_b> b(nErrors);
+		std::vector<std::vector<Felem> > m(nErrors, std::vector<Felem>(nErrors));
+		std::vector<Felem> b(nErrors);
 		for (size_t j = 0; j < nErrors; j++){
-			Fqelem_b alpha_i = fastPow(alpha, pos_errors[j]); //alpha^{i_1}
+			Felem alpha_i = fastPow(alpha, pos_errors[j]); //alpha^{i_1}
 			m[0][j] = fastPow(alpha, c*pos_errors[j]); //alpha^{c*i_j}
 			for (size_t i = 1; i < nErrors; i++){
 				m[i][j] = m[i-1][j]*alpha_i;
@@ -227,11 +281,14 @@ namespace alcp {
 
 		solve(m, b); //The solution is in b. m is changed
 
-		//Now we proceed to correct the errors
+		//Now we proceed to correct the errors. An error may be in a coefficient above
+		// the degree of w, and the corrected word may be of lower degree than w
+		std::vector<Fpelem_b> v(std::max<size_t>(length, w.deg() + 1), getZero(g.lc()));
+		std::copy(w.begin(), w.end(), v.begin());
 		for (size_t i = 0; i < nErrors; i++){
-			w[pos_errors[i]] -= static_cast<Fpxelem_b>(b[i])[0]; //Although b[i] is a Fqelem, it is actually a Fpelem
+			v[pos_errors[i]] -= static_cast<Fpxelem_b>(b[i])[0]; //Although b[i] is in the extension, it is actually a Fpelem
 		}
-		return w;
+		return Fpxelem_b(v);
 	}
 	Fpxelem_b BCH::getG() const { return g; }
 
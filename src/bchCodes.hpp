@@ -9,6 +9,7 @@
 #include "fpxelem.hpp"
 #include "fqelem.hpp"
 #include "fqxelem.hpp"
+#include "f2melem.hpp"
 
 #include "types.hpp"
 
@@ -29,7 +30,14 @@ namespace alcp {
 
 		size_t getDimension() const;
 	private:
+		// Decodes with alpha in the field of Fxelem's coefficients
+		template<class Fxelem>
+		Fpxelem_b decodeWith(const typename Fxelem::Felem &alpha, Fpxelem_b w) const;
+
 		Fqelem_b alpha;
+		// Binary codes work in GF(2^m) stored as bits, with this alpha instead
+		F2melem_b binaryAlpha;
+		bool binary;
 		Fpxelem_b g; //To generalize, this could be an Fqxelem
 		Fq_b field_ext;
 		size_t dimension;
@@ -4,8 +4,7 @@
 #include <vector>
 #include <utility>
 
-#include "fqelem.hpp"
-#include "fqxelem.hpp"
+#include "accumulator.hpp"
 
 namespace alcp {
 	/*TODO: Se puede en vez de usar polinomios, usar vectores de Felems
@@ -13,7 +12,7 @@ namespace alcp {
 	 * eficiente entre otras cosas
 	 *
 	 * f_m: polinomio que había la última vez que el grado cambió.
-	 * d_m: su discrepancia
+	 * d_m: su discrepancia. Se guarda su inverso, que solo cambia con el grado
 	 * f_k: polinomio actual
 	 * d_k: su discrepancia
 	 * l:	grado de f_k en cada momento
@@ -27,15 +26,16 @@ namespace alcp {
 		Fxelem f_m(getOne(s[0])), f_k(getOne(s[0]));
 		size_t l = 0;
 		int m = 1;
-		typename Fxelem::Felem d_m = getOne(s[0]);
+		typename Fxelem::Felem d_mInv = getOne(s[0]);
 
 		for (size_t i = 0; i < n; i++){
-			typename Fxelem::Felem d_k = getZero(s[0]);
+			Accumulator<typename Fxelem::Felem> acc(getZero(s[0]));
 			size_t min = f_k.deg();
 			if (l < min ) min = l;
 			for(size_t j = 0; j <= min; j++ ){
-				d_k += s[i-j]*f_k[j];
+				acc.addProduct(s[i-j], f_k[j]);
 			}
+			typename Fxelem::Felem d_k = acc.get();
 			if (d_k == 0){
 				m++;
 			}
@@ -43,17 +43,17 @@ namespace alcp {
 				Fxelem	aux(f_k);
 				std::vector<typename Fxelem::Felem> x_m(m+1, getZero(s[0]));
 				x_m[m] = 1;
-				f_k -= (d_k/d_m)*f_m*Fxelem(x_m);
+				f_k -= (d_k*d_mInv)*f_m*Fxelem(x_m);
 				//std::cout << f_k << std::endl;
 				f_m = aux;
 				m = 1;
 				l = i + 1 - l;
-				d_m = d_k;
+				d_mInv = d_k.inv();
 			}
 			else{
 				std::vector<typename Fxelem::Felem> x_m(m+1, getZero(s[0]));
 				x_m[m] = 1;
-				f_k -= (d_k/d_m)*f_m*Fxelem(x_m);
+				f_k -= (d_k*d_mInv)*f_m*Fxelem(x_m);
 				//std::cout << f_k << std::endl;
 				m++;
 			}
@@ -0,0 +1,96 @@
+#include "carrylessMul.hpp"
+
+#include "modArith.hpp"     // uint128_t
+
+#if !defined(ALCP_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALCP_CLMUL_X86 1
+#include <immintrin.h>
+#else
+#define ALCP_CLMUL_X86 0
+#endif
+
+namespace alcp {
+    namespace clmul {
+        Wide mul1Scalar(std::uint64_t a, std::uint64_t b) {
+            // tab[i] = a*i, with i a polynomial of degree < 4
+            uint128_t tab[16];
+            tab[0] = 0;
+            tab[1] = a;
+            for (unsigned i = 2; i < 16; ++i)
+                tab[i] = i % 2 != 0 ? tab[i - 1] ^ a : tab[i / 2] << 1;
+            uint128_t r = 0;
+            for (int s = 60; s >= 0; s -= 4)
+                r = (r << 4) ^ tab[(b >> s) & 15];
+            return {static_cast<std::uint64_t>(r), static_cast<std::uint64_t>(r >> 64)};
+        }
+
+        void mulScalar(std::uint64_t *r, const std::uint64_t *a, const std::uint64_t *b, std::size_t n) {
+            for (std::size_t i = 0; i < 2 * n; ++i)
+                r[i] = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                for (std::size_t j = 0; j < n; ++j) {
+                    const Wide p = mul1Scalar(a[i], b[j]);
+                    r[i + j] ^= p.lo;
+                    r[i + j + 1] ^= p.hi;
+                }
+        }
+
+        namespace {
+#if ALCP_CLMUL_X86
+            __attribute__((target("pclmul,sse2")))
+            Wide mul1Pclmul(std::uint64_t a, std::uint64_t b) {
+                const __m128i r = _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(a)),
+                                                       _mm_cvtsi64_si128(static_cast<long long>(b)), 0x00);
+                return {static_cast<std::uint64_t>(_mm_cvtsi128_si64(r)),
+                        static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(r, r)))};
+            }
+
+            __attribute__((target("pclmul,sse2")))
+            void mulPclmul(std::uint64_t *r, const std::uint64_t *a, const std::uint64_t *b, std::size_t n) {
+                for (std::size_t i = 0; i < 2 * n; ++i)
+                    r[i] = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    const __m128i ai = _mm_cvtsi64_si128(static_cast<long long>(a[i]));
+                    for (std::size_t j = 0; j < n; ++j) {
+                        const __m128i p = _mm_clmulepi64_si128(ai, _mm_cvtsi64_si128(static_cast<long long>(b[j])), 0x00);
+                        r[i + j] ^= static_cast<std::uint64_t>(_mm_cvtsi128_si64(p));
+                        r[i + j + 1] ^= static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(p, p)));
+                    }
+                }
+            }
+#endif
+
+            struct Kernels {
+                Wide (*mul1)(std::uint64_t, std::uint64_t);
+                void (*mul)(std::uint64_t *, const std::uint64_t *, const std::uint64_t *, std::size_t);
+                const char *name;
+            };
+
+            Kernels selectKernels() {
+#if ALCP_CLMUL_X86
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("pclmul"))
+                    return {mul1Pclmul, mulPclmul, "pclmul"};
+#endif
+                return {mul1Scalar, mulScalar, "scalar"};
+            }
+
+            const Kernels &kernels() {
+                static const Kernels k = selectKernels();
+                return k;
+            }
+        }
+
+        Wide mul1(std::uint64_t a, std::uint64_t b) {
+            return kernels().mul1(a, b);
+        }
+
+        void mul(std::uint64_t *r, const std::uint64_t *a, const std::uint64_t *b, std::size_t n) {
+            kernels().mul(r, a, b, n);
+        }
+
+        const char *backend() {
+            return kernels().name;
+        }
+    }
+}
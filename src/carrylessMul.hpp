@@ -0,0 +1,48 @@
+#ifndef __CARRYLESS_MUL_HPP
+#define __CARRYLESS_MUL_HPP
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+
+namespace alcp {
+    /**
+     * Products in GF(2)[X] of polynomials packed in 64-bit words
+     *
+     * Description:
+     *  The bit j of the word i is the coefficient of x^{64i + j}.
+     *  The 64x64 -> 128 products use the PCLMULQDQ instruction when the CPU
+     *   has it and a portable version otherwise. The best one is chosen the
+     *   first time a kernel is called. Defining ALCP_NO_SIMD forces the
+     *   portable version.
+     *
+     * Theoretical background:
+     *  The portable version multiplies a by the 16 polynomials of degree < 4
+     *   once, and then processes b in blocks of 4 bits from the top, as in
+     *   Horner's rule: r = x^4 r + a*block.
+     *  Longer polynomials are multiplied word by word (schoolbook).
+     *
+     * Complexity:
+     *  O(n^2) word products
+     */
+    namespace clmul {
+        // a*b, returned as {low word, high word}
+        struct Wide {
+            std::uint64_t lo, hi;
+        };
+
+        Wide mul1(std::uint64_t a, std::uint64_t b);
+
+        // r[0..2n) = a[0..n) * b[0..n). r must not overlap a or b
+        void mul(std::uint64_t *r, const std::uint64_t *a, const std::uint64_t *b, std::size_t n);
+
+        // Kernel in use: "pclmul" or "scalar"
+        const char *backend();
+
+        // The portable kernels, whatever the CPU supports
+        Wide mul1Scalar(std::uint64_t a, std::uint64_t b);
+
+        void mulScalar(std::uint64_t *r, const std::uint64_t *a, const std::uint64_t *b, std::size_t n);
+    }
+}
+
+#endif // __CARRYLESS_MUL_HPP
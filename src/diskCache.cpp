@@ -0,0 +1,213 @@
+#include "diskCache.hpp"
+
+#include <algorithm>    // std::equal
+#include <cstdio>       // std::rename, std::remove, std::snprintf
+#include <cstdlib>      // std::getenv
+#include <fstream>
+#include <mutex>
+#include <utility>      // std::move
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ALCP_CACHE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define ALCP_CACHE_MMAP 0
+#endif
+
+namespace alcp {
+    namespace diskCache {
+        namespace {
+            const std::uint32_t magic[2] = {0x50434C41, 0x48434143}; // "ALCP" "CACH"
+
+            std::mutex &lock() {
+                static std::mutex m;
+                return m;
+            }
+
+            std::string &dir() {
+                static std::string d = []() {
+                    const char *env = std::getenv("ALCP_CACHE_DIR");
+                    return std::string(env != nullptr ? env : "");
+                }();
+                return d;
+            }
+
+            constexpr std::uint64_t fnvOffset = 14695981039346656037ULL;
+
+            // One step of FNV-1a for every byte of w
+            void mix(std::uint64_t &h, std::uint32_t w) {
+                for (int i = 0; i < 4; ++i, w >>= 8) {
+                    h ^= w & 0xFF;
+                    h *= 1099511628211ULL;
+                }
+            }
+
+            // FNV-1a of the words in [first, last)
+            std::uint64_t hash(const std::uint32_t *first, const std::uint32_t *last) {
+                std::uint64_t h = fnvOffset;
+                for (; first != last; ++first)
+                    mix(h, *first);
+                return h;
+            }
+
+            // FNV-1a of the kind and the key
+            std::string path(const std::string &kind, const std::vector<std::uint32_t> &key) {
+                std::uint64_t h = fnvOffset;
+                for (char c : kind)
+                    mix(h, static_cast<unsigned char>(c));
+                for (std::uint32_t w : key)
+                    mix(h, w);
+                char hex[17];
+                std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+                return dir() + "/" + kind + "-" + hex + ".bin";
+            }
+
+            // The size of the file, which must be a positive multiple of 4 bytes
+            bool wordSize(std::streamoff size) {
+                return size > 0 && size % 4 == 0;
+            }
+        }
+
+        Entry::Entry(Entry &&e) {
+            *this = std::move(e);
+        }
+
+        Entry &Entry::operator=(Entry &&e) {
+            if (&e != this) {
+                this->release();
+                _map = e._map;
+                _mapSize = e._mapSize;
+                _words = std::move(e._words);
+                _first = e._first;
+                _last = e._last;
+                e._map = nullptr;
+                e._mapSize = 0;
+                e._first = e._last = nullptr;
+            }
+            return *this;
+        }
+
+        Entry::~Entry() {
+            this->release();
+        }
+
+        void Entry::release() {
+#if ALCP_CACHE_MMAP
+            if (_map != nullptr)
+                ::munmap(_map, _mapSize);
+#endif
+            _map = nullptr;
+            _mapSize = 0;
+            _words.clear();
+            _first = _last = nullptr;
+        }
+
+        void setDirectory(const std::string &d) {
+            std::lock_guard<std::mutex> guard(lock());
+            dir() = d;
+        }
+
+        std::string directory() {
+            std::lock_guard<std::mutex> guard(lock());
+            return dir();
+        }
+
+        bool enabled() {
+            return !directory().empty();
+        }
+
+        bool load(const std::string &kind, const std::vector<std::uint32_t> &key, Entry &entry) {
+            Entry read;
+            {
+                std::lock_guard<std::mutex> guard(lock());
+                if (dir().empty())
+                    return false;
+                const std::string file = path(kind, key);
+#if ALCP_CACHE_MMAP
+                const int fd = ::open(file.c_str(), O_RDONLY);
+                if (fd < 0)
+                    return false;
+                struct stat st;
+                if (::fstat(fd, &st) != 0 || !wordSize(st.st_size)) {
+                    ::close(fd);
+                    return false;
+                }
+                read._mapSize = static_cast<std::size_t>(st.st_size);
+                void *map = ::mmap(nullptr, read._mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (map == MAP_FAILED)
+                    return false;
+                read._map = map;
+                read._first = static_cast<const std::uint32_t *>(map);
+                read._last = read._first + read._mapSize / 4;
+#else
+                std::ifstream in(file, std::ios::binary | std::ios::ate);
+                if (!in)
+                    return false;
+                const std::streamoff size = in.tellg();
+                if (!wordSize(size))
+                    return false;
+                read._words.resize(static_cast<std::size_t>(size) / 4);
+                in.seekg(0);
+                if (!in.read(reinterpret_cast<char *>(read._words.data()), size))
+                    return false;
+                read._first = read._words.data();
+                read._last = read._first + read._words.size();
+#endif
+            }
+            // magic, version, key size, key, payload size, payload, hash
+            const std::uint32_t *words = read._first;
+            const std::size_t size = read.size(), header = 4 + key.size();
+            if (size < header + 3 || words[0] != magic[0] || words[1] != magic[1] || words[2] != version ||
+                words[3] != key.size() || !std::equal(key.begin(), key.end(), words + 4) ||
+                words[header] != size - header - 3)
+                return false;
+            const std::uint32_t *first = words + header + 1, *last = words + size - 2;
+            const std::uint64_t h = hash(first, last);
+            if (last[0] != static_cast<std::uint32_t>(h) || last[1] != static_cast<std::uint32_t>(h >> 32))
+                return false;
+            read._first = first;
+            read._last = last;
+            entry = std::move(read);
+            return true;
+        }
+
+        void store(const std::string &kind, const std::vector<std::uint32_t> &key,
+                   const std::vector<std::uint32_t> &payload) {
+            std::vector<std::uint32_t> words{magic[0], magic[1], version, static_cast<std::uint32_t>(key.size())};
+            words.insert(words.end(), key.begin(), key.end());
+            words.push_back(static_cast<std::uint32_t>(payload.size()));
+            words.insert(words.end(), payload.begin(), payload.end());
+            const std::uint64_t h = hash(payload.data(), payload.data() + payload.size());
+            words.push_back(static_cast<std::uint32_t>(h));
+            words.push_back(static_cast<std::uint32_t>(h >> 32));
+
+            std::lock_guard<std::mutex> guard(lock());
+            if (dir().empty())
+                return;
+            const std::string file = path(kind, key);
+#if ALCP_CACHE_MMAP
+            const std::string tmp = file + "." + std::to_string(::getpid()) + ".tmp";
+#else
+            const std::string tmp = file + ".tmp";
+#endif
+            {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                if (!out)
+                    return;
+                out.write(reinterpret_cast<const char *>(words.data()),
+                          static_cast<std::streamsize>(words.size() * sizeof(std::uint32_t)));
+                if (!out) {
+                    out.close();
+                    std::remove(tmp.c_str());
+                    return;
+                }
+            }
+            if (std::rename(tmp.c_str(), file.c_str()) != 0)
+                std::remove(tmp.c_str());
+        }
+    }
+}
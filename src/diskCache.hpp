@@ -0,0 +1,171 @@
+#ifndef __DISK_CACHE_HPP
+#define __DISK_CACHE_HPP
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t
+#include <string>
+#include <type_traits>  // std::decay
+#include <vector>
+
+namespace alcp {
+    /**
+     * Persistent cache of the data that is expensive to compute
+     *
+     * Description:
+     *  The moduli found by Fq(p, m), the Frobenius matrices and primitive
+     *   elements of the fields and the generator polynomials of the BCH codes
+     *   are stored in files in a directory, so another process finds them
+     *   instead of computing them again.
+     *  The directory is given by setDirectory or by the environment variable
+     *   ALCP_CACHE_DIR. The cache is disabled while it is empty, which is the
+     *   default.
+     *  An entry is identified by a kind (e.g. "modulus") and a key, both
+     *   stored in the file. Its name is the kind and a hash of the key.
+     *
+     * Format:
+     *  Everything is a 32-bit word in the byte order of the machine, so a
+     *   mapped file is an array of words: the magic "ALCP" "CACH" (which
+     *   fails for the other byte order), the version, the size of the key,
+     *   the key, the size of the payload, the payload and its 64-bit FNV-1a
+     *   hash (low word first).
+     *  An integer n >= 0 is stored as its number of digits in base 2^32 and
+     *   the digits, from the least significant one. A polynomial is stored as
+     *   its number of coefficients and the coefficients.
+     *  Files with another version, another key, a wrong size or a wrong hash
+     *   are ignored and overwritten. The users of an entry check that it is
+     *   also meaningful (e.g. that a modulus is irreducible), as the file may
+     *   have been written by another build. A file is written with another
+     *   name and then renamed, so readers never see a partial file, and a
+     *   file is never modified once it has that name, so it can be mapped.
+     *  Where mmap is available an Entry points into the mapping of its file,
+     *   so the payload is read in place. Elsewhere the file is read into it.
+     *
+     * Complexity:
+     *  O(size of the entry) to check and to write it
+     */
+    namespace diskCache {
+        constexpr std::uint32_t version = 2;
+
+        // An empty directory disables the cache
+        void setDirectory(const std::string &dir);
+
+        std::string directory();
+
+        bool enabled();
+
+        // The payload of an entry. It keeps the file mapped while it lives
+        class Entry {
+        public:
+            Entry() = default;
+
+            Entry(const Entry &) = delete;
+
+            Entry &operator=(const Entry &) = delete;
+
+            Entry(Entry &&e);
+
+            Entry &operator=(Entry &&e);
+
+            ~Entry();
+
+            const std::uint32_t *begin() const { return _first; }
+
+            const std::uint32_t *end() const { return _last; }
+
+            std::size_t size() const { return static_cast<std::size_t>(_last - _first); }
+
+        private:
+            friend bool load(const std::string &kind, const std::vector<std::uint32_t> &key, Entry &entry);
+
+            void release();
+
+            void *_map = nullptr;
+            std::size_t _mapSize = 0;
+            // Without mmap, the words of the file
+            std::vector<std::uint32_t> _words;
+            const std::uint32_t *_first = nullptr, *_last = nullptr;
+        };
+
+        // Whether there is a valid entry. Then entry holds its payload
+        bool load(const std::string &kind, const std::vector<std::uint32_t> &key, Entry &entry);
+
+        // Errors writing are ignored, as the cache is only an optimization
+        void store(const std::string &kind, const std::vector<std::uint32_t> &key,
+                   const std::vector<std::uint32_t> &payload);
+
+        template<class Integer>
+        void put(std::vector<std::uint32_t> &words, Integer n) {
+            const Integer base = Integer(1LL << 32);
+            std::vector<std::uint32_t> digits;
+            for (; n != 0; n /= base)
+                digits.push_back(static_cast<std::uint32_t>(static_cast<long long>(n % base)));
+            words.push_back(static_cast<std::uint32_t>(digits.size()));
+            words.insert(words.end(), digits.begin(), digits.end());
+        }
+
+        inline void put(std::vector<std::uint32_t> &words, std::size_t n) {
+            words.push_back(static_cast<std::uint32_t>(n));
+        }
+
+        template<class Fxelem>
+        void putPolynomial(std::vector<std::uint32_t> &words, const Fxelem &f) {
+            using Integer = typename std::decay<decltype(f.getSize())>::type;
+            put(words, f.deg() + 1);
+            for (std::size_t i = 0; i <= f.deg(); ++i)
+                put(words, static_cast<Integer>(f[i]));
+        }
+
+        // Sequential reading of a payload. Every read returns false past the end
+        class Reader {
+        public:
+            Reader(const std::uint32_t *first, const std::uint32_t *last) : _it(first), _end(last) { }
+
+            explicit Reader(const Entry &entry) : Reader(entry.begin(), entry.end()) { }
+
+            bool get(std::size_t &n) {
+                if (_it == _end)
+                    return false;
+                n = *_it++;
+                return true;
+            }
+
+            template<class Integer>
+            bool get(Integer &n) {
+                std::size_t digits;
+                if (!this->get(digits) || static_cast<std::size_t>(_end - _it) < digits)
+                    return false;
+                const Integer base = Integer(1LL << 32);
+                n = Integer(0);
+                for (std::size_t i = digits; i-- > 0;)
+                    n = n * base + Integer(static_cast<long long>(_it[i]));
+                _it += digits;
+                return true;
+            }
+
+            // A polynomial over field. It fails if a coefficient is not reduced
+            template<class Fxelem, class Field>
+            bool getPolynomial(Fxelem &f, const Field &field) {
+                using Integer = typename std::decay<decltype(field.getP())>::type;
+                std::size_t n;
+                if (!this->get(n) || n == 0)
+                    return false;
+                std::vector<typename Fxelem::Felem> coefs;
+                for (std::size_t i = 0; i < n; ++i) {
+                    Integer c;
+                    if (!this->get(c) || c >= field.getP())
+                        return false;
+                    coefs.push_back(field.get(c));
+                }
+                f = Fxelem(coefs);
+                return true;
+            }
+
+            bool done() const { return _it == _end; }
+
+        private:
+            const std::uint32_t *_it, *_end;
+        };
+    }
+}
+
+#endif // __DISK_CACHE_HPP
@@ -0,0 +1,438 @@
+#ifndef __F2MELEM_HPP
+#define __F2MELEM_HPP
+
+#include <algorithm>    // std::equal, std::lexicographical_compare
+#include <cstdint>      // std::uint64_t
+#include <map>
+#include <memory>       // std::unique_ptr
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "quotientRing.hpp"
+#include "fpelem.hpp"
+#include "fpxelem.hpp"
+#include "fqelem.hpp"           // Fq(p, m) finds the irreducible polynomial
+#include "carrylessMul.hpp"
+#include "modArith.hpp"         // uint128_t
+#include "types.hpp"
+#include "exceptions.hpp"
+
+namespace alcp {
+    template<class Integer>
+    class F2melem;
+
+    template<class Integer>
+    struct F2mContext;
+
+    /**
+     * Coefficients of an element of GF(2^m) = F_2[x]/(f)
+     *
+     * Description:
+     *  A polynomial of degree < m over F_2 packed in ceil(m/64) words, the
+     *   bit j of the word i being the coefficient of x^{64i + j}. The first
+     *   word is stored inside the object, so the elements of GF(2^m) with
+     *   m <= 64 are never allocated in the heap.
+     */
+    class F2mBits {
+    public:
+        F2mBits() = default;
+
+        explicit F2mBits(std::size_t words) : _n(words) {
+            if (words > 1)
+                _heap.assign(words, 0);
+        }
+
+        std::size_t size() const { return _n; }
+
+        std::uint64_t *data() { return _n > 1 ? _heap.data() : &_inline; }
+
+        const std::uint64_t *data() const { return _n > 1 ? _heap.data() : &_inline; }
+
+        std::uint64_t &operator[](std::size_t i) { return this->data()[i]; }
+
+        const std::uint64_t &operator[](std::size_t i) const { return this->data()[i]; }
+
+        friend bool operator==(const F2mBits &lhs, const F2mBits &rhs) {
+            return lhs._n == rhs._n && std::equal(lhs.data(), lhs.data() + lhs._n, rhs.data());
+        }
+
+        friend bool operator!=(const F2mBits &lhs, const F2mBits &rhs) { return !(lhs == rhs); }
+
+        // Whether it is the constant n
+        friend bool operator==(const F2mBits &lhs, std::uint64_t n) {
+            if (lhs._n == 0)
+                return n == 0;
+            for (std::size_t i = 1; i < lhs._n; ++i)
+                if (lhs[i] != 0)
+                    return false;
+            return lhs[0] == n;
+        }
+
+        friend bool operator<(const F2mBits &lhs, const F2mBits &rhs) {
+            return std::lexicographical_compare(lhs.data(), lhs.data() + lhs._n, rhs.data(), rhs.data() + rhs._n);
+        }
+
+        friend bool operator>(const F2mBits &lhs, const F2mBits &rhs) { return rhs < lhs; }
+
+        friend bool operator<=(const F2mBits &lhs, const F2mBits &rhs) { return !(rhs < lhs); }
+
+        friend bool operator>=(const F2mBits &lhs, const F2mBits &rhs) { return !(lhs < rhs); }
+
+        // Hexadecimal, most significant word first
+        friend std::string to_string(const F2mBits &a) {
+            static const char digits[] = "0123456789abcdef";
+            std::string ret = "0x";
+            for (std::size_t i = a._n; i-- > 0;)
+                for (int s = 60; s >= 0; s -= 4)
+                    ret += digits[(a[i] >> s) & 15];
+            return ret;
+        }
+
+    private:
+        std::size_t _n = 0;
+        std::uint64_t _inline = 0;
+        std::vector<std::uint64_t> _heap;
+    };
+
+    template<class Integer = big_int>
+    class F2m {
+    static_assert(is_integral<Integer>::value, "Type is not a supported integer.");
+    public:
+        // The same modulus as Fq(2, m)
+        explicit F2m(std::size_t m) : _ctx(F2mContext<Integer>::intern(Fq<Integer>(2, m).mod(), true)) { }
+
+        F2m(const Fpxelem<Integer> &mod) : _ctx(F2mContext<Integer>::intern(mod)) { }
+
+        F2m(const F2m<Integer> &f) = default;
+
+        F2melem<Integer> get(Integer n) const {
+            F2mBits r(_ctx->words);
+            r[0] = static_cast<std::uint64_t>(static_cast<long long>(n % 2 == 0 ? 0 : 1));
+            return F2melem<Integer>(std::move(r), _ctx);
+        }
+
+        F2melem<Integer> get(const Fpxelem<Integer> &f) const {
+            return F2melem<Integer>(_ctx->fromPolynomial(f), _ctx);
+        }
+
+        const F2melem<Integer> &zero() const { return _ctx->zero; }
+
+        const F2melem<Integer> &one() const { return _ctx->one; }
+
+        Fpxelem<Integer> mod() const { return _ctx->modulus; }
+
+        Fp<Integer> getBaseField() const { return _ctx->modulus.lc().getField(); }
+
+        Integer getSize() const {
+            if (_ctx->size == 0)
+                throw EOperationUnsupported("The size of F2^" + std::to_string(_ctx->m) +
+                                            " does not fit in its integer type.");
+            return _ctx->size;
+        }
+
+        Integer getP() const { return 2; }
+
+        std::size_t getM() const { return _ctx->m; }
+
+        // The element with bits k is the k-th one, so they are in the same order as in Fq
+        std::vector<F2melem<Integer>> getElems() const {
+            if (_ctx->m >= 64)
+                throw EOperationUnsupported("The elements of F2^" + std::to_string(_ctx->m) +
+                                            " cannot be enumerated.");
+            std::vector<F2melem<Integer>> ret;
+            const std::uint64_t size = std::uint64_t(1) << _ctx->m;
+            ret.reserve(size);
+            for (std::uint64_t k = 0; k < size; ++k) {
+                F2mBits r(_ctx->words);
+                r[0] = k;
+                ret.push_back(F2melem<Integer>(std::move(r), _ctx));
+            }
+            return ret;
+        }
+
+        // Fields are interned, so two fields are equal iff they share the context
+        bool operator==(const F2m &rhs) const { return _ctx == rhs._ctx; }
+
+        bool operator!=(const F2m &rhs) const { return _ctx != rhs._ctx; }
+
+        friend std::string to_string(const F2m<Integer> &f) {
+            return "F2^" + std::to_string(f.getM());
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const F2m<Integer> &f) {
+            os << to_string(f);
+            return os;
+        }
+
+    private:
+        friend class F2melem<Integer>;
+
+        // As in Fp
+        F2m(const F2mContext<Integer> *ctx, bool) : _ctx(ctx) { }
+
+        const F2mContext<Integer> *_ctx = nullptr;
+    };
+
+
+    template<class Integer = big_int>
+    class F2melem : public QuotientRing<F2melem, F2mBits, Integer, const F2mContext<Integer> *> {
+    private:
+        // ::alcp::F2melem still necessary for clang 3.9
+        // http://stackoverflow.com/questions/17687459/clang-not-accepting-use-of-template-template-parameter-when-using-crtp
+        using FBase = QuotientRing<::alcp::F2melem, F2mBits, Integer, const F2mContext<Integer> *>;
+
+    public:
+        using F = F2m<Integer>;
+        using FBase::FBase;
+        using FBase::operator=;
+
+        F2melem() = default;
+        F2melem(const F2melem & e)  = default;
+        F2melem(F2melem && e)  = default;
+        F2melem & operator=(const F2melem & e)  = default;
+        F2melem & operator=(F2melem && e)  = default;
+
+        F getField() const{ return F(this->mod(), true); }
+
+        // The element as a polynomial of degree < m
+        explicit operator Fpxelem<Integer>() const { return this->mod()->toPolynomial(this->_num); }
+
+        friend std::string to_string(const F2melem &e) {
+            return to_string(static_cast<Fpxelem<Integer>>(e), 't');
+        }
+
+        friend std::string to_string_coef(const F2melem& e){
+            const Fpxelem<Integer> pol(e);
+            if(pol.deg() == 0)
+                return "+" + to_string(pol.lc());
+            else if(pol.nonZeroCoefs() == 1)
+                return "+" + to_string(pol, 't');
+            return "+(" + to_string(pol, 't') + ")" ;
+        }
+
+        // e^{2^k}, computed with k squarings
+        friend F2melem frobenius(const F2melem &e, std::size_t k = 1) {
+            F2melem ret(e);
+            for (k %= e.mod()->m; k > 0; --k)
+                ret._num = e.mod()->mul(ret._num, ret._num);
+            return ret;
+        }
+
+        // The only r with r^2 = e, i.e. e^{2^{m-1}}
+        friend F2melem pthRoot(const F2melem &e) { return frobenius(e, e.mod()->m - 1); }
+
+        /**
+         * Minimal polynomial of e over F_2
+         *
+         * Description:
+         *  The product of X - r over the conjugates r = e, e^2, e^4, ... of e.
+         *
+         * Theoretical background:
+         *  The roots of the minimal polynomial are the orbit of e under the
+         *   Frobenius map, and they are simple, so its coefficients are the
+         *   elementary symmetric functions of the orbit and lie in F_2.
+         *
+         * Complexity:
+         *  O(d^2) products, where d <= m is the size of the orbit
+         */
+        friend Fpxelem<Integer> minpoly(const F2melem &e) {
+            // Coefficients from the lowest degree, (X - r) c = X c + r c
+            std::vector<F2melem> c{e.mod()->one};
+            F2melem r = e;
+            do {
+                c.push_back(e.mod()->one);
+                for (std::size_t i = c.size() - 2; i > 0; --i)
+                    c[i] = c[i - 1] + r * c[i];
+                c[0] = r * c[0];
+                r = frobenius(r);
+            } while (r != e);
+            const Fp<Integer> f2 = e.getField().getBaseField();
+            std::vector<Fpelem<Integer>> ret;
+            for (const F2melem &a : c)
+                ret.push_back(a == 0 ? f2.zero() : f2.one());
+            return Fpxelem<Integer>(ret);
+        }
+
+    private:
+        friend class F2m<Integer>;
+        friend struct F2mContext<Integer>;
+    };
+
+    /**
+     * Shared data of the field GF(2^m) = F_2[x]/(f)
+     *
+     * Description:
+     *  Interned per modulus, as FqContext. f is stored as the list of
+     *   exponents t < m of its nonzero terms (its taps), so that reducing
+     *   costs a few shifts and XORs when f is sparse (a trinomial or a
+     *   pentanomial).
+     *
+     * Theoretical background:
+     *  Let r = h x^m + l with deg(l) < m. Since x^m = sum_t x^t (mod f),
+     *   r = l + sum_t h x^t (mod f). Every round lowers the degree of r by
+     *   m - max(t), so two rounds are enough if max(t) <= m/2.
+     *  Inversion uses Fermat: a^{-1} = a^{2^m - 2} = a^2 a^4 ... a^{2^{m-1}}.
+     *
+     * Complexity:
+     *  Product: O(w^2) word products plus O(m / (m - max(t)) |taps| w)
+     *   for the reduction, with w = ceil(m/64)
+     *  Inverse: O(m) products
+     */
+    template<class Integer>
+    struct F2mContext {
+        Fpxelem<Integer> modulus;
+        std::size_t m, words;
+        // f = x^m + sum_{t in taps} x^t
+        std::vector<std::size_t> taps;
+        // 2^m, or 0 if it does not fit in an Integer
+        Integer size;
+        F2melem<Integer> zero, one;
+
+        static const F2mContext *intern(const Fpxelem<Integer> &f, bool isIrreducible = false) {
+            static std::mutex lock;
+            static std::map<std::vector<std::size_t>, std::unique_ptr<F2mContext>> registry;
+
+#ifndef ALCP_NO_CHECKS
+            if (f.getSize() != 2)
+                throw EOperationUnsupported("The polynomial " + to_string(f) + " is not over F2.");
+#endif
+            std::vector<std::size_t> key;
+            for (std::size_t i = 0; i <= f.deg(); ++i)
+                if (f[i] != 0)
+                    key.push_back(i);
+
+            std::lock_guard<std::mutex> guard(lock);
+            auto it = registry.find(key);
+            if (it != registry.end())
+                return it->second.get();
+            if (!isIrreducible && !f.irreducible())
+                throw EFPXNotIrreducible("The polinomial provided to F2m was not irreducible.");
+            std::unique_ptr<F2mContext> ctx(new F2mContext(f));
+            return (registry[key] = std::move(ctx)).get();
+        }
+
+        F2mBits fromPolynomial(const Fpxelem<Integer> &a) const {
+#ifndef ALCP_NO_CHECKS
+            if (a.lc().getField() != modulus.lc().getField())
+                throw EOperationUnsupported("The polynomial " + to_string(a) + " is not over F2.");
+#endif
+            const Fpxelem<Integer> r = a.deg() >= m ? a % modulus : a;
+            F2mBits ret(words);
+            for (std::size_t i = 0; i <= r.deg(); ++i)
+                if (r[i] != 0)
+                    ret[i / 64] |= std::uint64_t(1) << (i % 64);
+            return ret;
+        }
+
+        Fpxelem<Integer> toPolynomial(const F2mBits &a) const {
+            const Fp<Integer> f2 = modulus.lc().getField();
+            std::vector<Fpelem<Integer>> ret(m, f2.zero());
+            for (std::size_t i = 0; i < m; ++i)
+                if ((a[i / 64] >> (i % 64)) & 1)
+                    ret[i] = f2.one();
+            return Fpxelem<Integer>(ret);
+        }
+
+        F2mBits mul(const F2mBits &a, const F2mBits &b) const {
+            if (words == 1) {
+                const clmul::Wide p = clmul::mul1(a[0], b[0]);
+                F2mBits ret(1);
+                ret[0] = this->reduce1((uint128_t(p.hi) << 64) | p.lo);
+                return ret;
+            }
+            std::vector<std::uint64_t> prod(2 * words);
+            clmul::mul(prod.data(), a.data(), b.data(), words);
+            return this->reduce(prod);
+        }
+
+        F2mBits inv(const F2mBits &a) const {
+            F2mBits ret = one._num, pow = a;
+            for (std::size_t i = 1; i < m; ++i) {
+                pow = this->mul(pow, pow);
+                ret = this->mul(ret, pow);
+            }
+            return ret;
+        }
+
+    private:
+        explicit F2mContext(const Fpxelem<Integer> &f) :
+                modulus(f), m(f.deg()), words((f.deg() + 63) / 64), size(powFits(Integer(2), f.deg()) ? fastPow(Integer(2), f.deg()) : Integer(0)),
+                zero(F2mBits(words), this), one(F2mBits(words), this) {
+            for (std::size_t i = m; i-- > 0;)
+                if (f[i] != 0)
+                    taps.push_back(i);
+            one._num[0] = 1;
+        }
+
+        // r of degree < 2m - 1 <= 127
+        std::uint64_t reduce1(uint128_t r) const {
+            const uint128_t mask = (uint128_t(1) << m) - 1;
+            for (uint128_t h = r >> m; h != 0; h = r >> m) {
+                r &= mask;
+                for (std::size_t t : taps)
+                    r ^= h << t;
+            }
+            return static_cast<std::uint64_t>(r);
+        }
+
+        // r of 2*words words and degree < 2m - 1
+        F2mBits reduce(std::vector<std::uint64_t> &r) const {
+            const std::size_t wm = m / 64, bm = m % 64;
+            std::vector<std::uint64_t> h(words + 1);
+            while (true) {
+                // h = r >> m
+                bool zero = true;
+                for (std::size_t i = 0; i < h.size(); ++i) {
+                    const std::size_t j = wm + i;
+                    const std::uint64_t lo = j < r.size() ? r[j] : 0, hi = j + 1 < r.size() ? r[j + 1] : 0;
+                    h[i] = bm == 0 ? lo : (lo >> bm) | (hi << (64 - bm));
+                    zero = zero && h[i] == 0;
+                }
+                if (zero)
+                    break;
+                r[wm] &= (std::uint64_t(1) << bm) - 1;
+                std::fill(r.begin() + wm + 1, r.end(), 0);
+                // r += h x^t
+                for (std::size_t t : taps) {
+                    const std::size_t wt = t / 64, bt = t % 64;
+                    for (std::size_t i = 0; i < h.size() && wt + i < r.size(); ++i) {
+                        r[wt + i] ^= h[i] << bt;
+                        if (bt != 0 && wt + i + 1 < r.size())
+                            r[wt + i + 1] ^= h[i] >> (64 - bt);
+                    }
+                }
+            }
+            F2mBits ret(words);
+            std::copy(r.begin(), r.begin() + words, ret.data());
+            return ret;
+        }
+    };
+
+    // Modular operations for the elements of GF(2^m), which only store their context
+    template<class Int>
+    F2mBits addMod(const F2mBits &a, const F2mBits &b, const F2mContext<Int> *ctx) {
+        F2mBits ret(ctx->words);
+        for (std::size_t i = 0; i < ctx->words; ++i)
+            ret[i] = a[i] ^ b[i];
+        return ret;
+    }
+
+    // In characteristic 2, a - b = a + b and -a = a
+    template<class Int>
+    F2mBits subMod(const F2mBits &a, const F2mBits &b, const F2mContext<Int> *ctx) { return addMod(a, b, ctx); }
+
+    template<class Int>
+    F2mBits negMod(const F2mBits &a, const F2mContext<Int> *) { return a; }
+
+    template<class Int>
+    F2mBits mulMod(const F2mBits &a, const F2mBits &b, const F2mContext<Int> *ctx) { return ctx->mul(a, b); }
+
+    template<class Int>
+    F2mBits invMod(const F2mBits &a, const F2mContext<Int> *ctx) { return ctx->inv(a); }
+
+    using F2melem_b = F2melem<big_int>;
+    using F2m_b = F2m<big_int>;
+}
+
+#endif // __F2MELEM_HPP
@@ -0,0 +1,58 @@
+#ifndef __F2MXELEM_HPP
+#define __F2MXELEM_HPP
+
+#include <vector>
+
+#include "f2melem.hpp"
+#include "polRing.hpp"
+
+namespace alcp {
+    template<class Integer>
+    class F2mxelem : public PolynomialRing<F2mxelem, F2melem<Integer>, Integer> {
+    private:
+        // ::alcp::F2mxelem still necessary for clang 3.9
+        // http://stackoverflow.com/questions/17687459/clang-not-accepting-use-of-template-template-parameter-when-using-crtp
+        using FBase = PolynomialRing<::alcp::F2mxelem, F2melem<Integer>, Integer>;
+    public:
+        // Base field
+        using F = F2m<Integer>;
+        using Felem = F2melem<Integer>;
+
+        // Inherit ctor
+        using FBase::FBase;
+
+        F2mxelem() = default;
+
+        const F2m<Integer> getField() const {
+            return this->lc().getField();
+        }
+
+        Integer getSize() const {
+            return this->getField().getSize();
+        }
+
+        friend F2mxelem<Integer> getZero(const F2mxelem<Integer> &e) { return F2mxelem<Integer>(getZero(e.lc())); }
+
+        friend F2mxelem<Integer> getOne(const F2mxelem<Integer> &e) { return F2mxelem<Integer>(getOne(e.lc())); }
+
+        friend F2mxelem<Integer> unit(const F2mxelem<Integer> &e) { return e.lc(); }
+
+        friend bool compatible(const F2mxelem<Integer> &lhs, const F2mxelem<Integer> &rhs) {
+            return lhs.getField() == rhs.getField();
+        }
+
+        friend bool operator==(const F2mxelem<Integer> &lhs, Integer rhs) {
+            return lhs.deg() == 0 && lhs.lc() == lhs.getField().get(rhs);
+        }
+
+        friend bool operator==(Integer lhs, const F2mxelem<Integer> &rhs) { return rhs == lhs; }
+
+        friend bool operator!=(const F2mxelem<Integer> &lhs, Integer rhs) { return !(lhs == rhs); }
+
+        friend bool operator!=(Integer lhs, const F2mxelem<Integer> &rhs) { return !(rhs == lhs); }
+    };
+
+    using F2mxelem_b = F2mxelem<big_int>;
+}
+
+#endif // __F2MXELEM_HPP
@@ -0,0 +1,314 @@
+#include "f2xelem.hpp"
+
+#include <algorithm>    // std::min, std::copy, std::fill
+#include <utility>      // std::swap, std::make_pair
+
+#include "carrylessMul.hpp"
+
+namespace alcp {
+    namespace {
+        // Words of scratch used by mulWords for n words
+        std::size_t scratchWords(std::size_t n) {
+            if (n < F2xelem::karatsubaWords)
+                return 0;
+            const std::size_t k = (n + 1) / 2;
+            return 4 * k + scratchWords(k);
+        }
+
+        // r[0..2n) = a*b, where a and b have n words. r must not overlap a, b or
+        //  scratch, which has scratchWords(n) words
+        void mulWords(std::uint64_t *r, const std::uint64_t *a, const std::uint64_t *b, std::size_t n,
+                      std::uint64_t *scratch) {
+            if (n < F2xelem::karatsubaWords) {
+                clmul::mul(r, a, b, n);
+                return;
+            }
+            // a = a0 + a1 X with X = x^{64k}, where a0 has k words and a1 has h <= k
+            const std::size_t k = (n + 1) / 2, h = n - k;
+            // a0 b0 in r[0..2k) and a1 b1 in r[2k..2n)
+            mulWords(r, a, b, k, scratch);
+            mulWords(r + 2 * k, a + k, b + k, h, scratch);
+            // (a0 + a1)(b0 + b1) - a0 b0 - a1 b1 in z1
+            std::uint64_t *sa = scratch, *sb = scratch + k, *z1 = scratch + 2 * k;
+            for (std::size_t i = 0; i < k; ++i) {
+                sa[i] = i < h ? a[i] ^ a[i + k] : a[i];
+                sb[i] = i < h ? b[i] ^ b[i + k] : b[i];
+            }
+            mulWords(z1, sa, sb, k, scratch + 4 * k);
+            for (std::size_t i = 0; i < 2 * k; ++i)
+                z1[i] ^= r[i];
+            for (std::size_t i = 0; i < 2 * h; ++i)
+                z1[i] ^= r[2 * k + i];
+            for (std::size_t i = 0; i < 2 * k; ++i)
+                r[k + i] ^= z1[i];
+        }
+
+        // r += b x^s
+        void addShifted(std::vector<std::uint64_t> &r, const std::vector<std::uint64_t> &b, std::size_t s) {
+            const std::size_t ws = s / 64, bs = s % 64;
+            if (r.size() < b.size() + ws + 1)
+                r.resize(b.size() + ws + 1, 0);
+            for (std::size_t i = 0; i < b.size(); ++i) {
+                r[i + ws] ^= b[i] << bs;
+                if (bs != 0)
+                    r[i + ws + 1] ^= b[i] >> (64 - bs);
+            }
+        }
+
+        // The 32 bits of x in the even positions
+        std::uint64_t spread(std::uint64_t x) {
+            x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+            x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+            x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            x = (x | (x << 2)) & 0x3333333333333333ULL;
+            x = (x | (x << 1)) & 0x5555555555555555ULL;
+            return x;
+        }
+
+        // Inverse of spread: the bits of x in the even positions, packed
+        std::uint64_t unspread(std::uint64_t x) {
+            x &= 0x5555555555555555ULL;
+            x = (x | (x >> 1)) & 0x3333333333333333ULL;
+            x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+            x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+            x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+            x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+            return x;
+        }
+
+        void trim(std::vector<std::uint64_t> &w) {
+            while (!w.empty() && w.back() == 0)
+                w.pop_back();
+        }
+
+        std::size_t degree(const std::vector<std::uint64_t> &w) {
+            return w.empty() ? 0 : 64 * (w.size() - 1) + 63 - __builtin_clzll(w.back());
+        }
+
+        // r = r mod b, and the quotient is added to q if it is not null. b is not zero
+        void reduce(std::vector<std::uint64_t> &r, const F2xelem &b, std::vector<std::uint64_t> *q) {
+            const std::size_t db = b.deg();
+            trim(r);
+            while (!r.empty() && degree(r) >= db) {
+                const std::size_t s = degree(r) - db;
+                if (q != nullptr) {
+                    if (q->size() <= s / 64)
+                        q->resize(s / 64 + 1, 0);
+                    (*q)[s / 64] |= std::uint64_t(1) << (s % 64);
+                }
+                addShifted(r, b.words(), s);
+                trim(r);
+            }
+        }
+    }
+
+    F2xelem::F2xelem(int c) {
+        if (c % 2 != 0)
+            _w.push_back(1);
+    }
+
+    F2xelem::F2xelem(std::vector<std::uint64_t> words) : _w(std::move(words)) {
+        this->removeTrailingZeros();
+    }
+
+    F2xelem F2xelem::monomial(std::size_t k) {
+        F2xelem ret;
+        ret.setCoef(k, true);
+        return ret;
+    }
+
+    std::size_t F2xelem::deg() const { return degree(_w); }
+
+    void F2xelem::setCoef(std::size_t i, bool c) {
+        if (c) {
+            if (_w.size() <= i / 64)
+                _w.resize(i / 64 + 1, 0);
+            _w[i / 64] |= std::uint64_t(1) << (i % 64);
+        }
+        else if (i / 64 < _w.size()) {
+            _w[i / 64] &= ~(std::uint64_t(1) << (i % 64));
+            this->removeTrailingZeros();
+        }
+    }
+
+    F2xelem &F2xelem::operator+=(const F2xelem &rhs) {
+        if (_w.size() < rhs._w.size())
+            _w.resize(rhs._w.size(), 0);
+        for (std::size_t i = 0; i < rhs._w.size(); ++i)
+            _w[i] ^= rhs._w[i];
+        this->removeTrailingZeros();
+        return *this;
+    }
+
+    F2xelem &F2xelem::operator%=(const F2xelem &rhs) {
+        if (rhs._w.empty())
+            throw EOperationUnsupported("Error. Division by zero.");
+        reduce(_w, rhs, nullptr);
+        return *this;
+    }
+
+    F2xelem &F2xelem::operator<<=(std::size_t k) {
+        if (_w.empty())
+            return *this;
+        std::vector<std::uint64_t> ret;
+        addShifted(ret, _w, k);
+        _w = std::move(ret);
+        this->removeTrailingZeros();
+        return *this;
+    }
+
+    F2xelem &F2xelem::operator>>=(std::size_t k) {
+        const std::size_t ws = k / 64, bs = k % 64;
+        if (ws >= _w.size()) {
+            _w.clear();
+            return *this;
+        }
+        for (std::size_t i = 0; i + ws < _w.size(); ++i) {
+            _w[i] = _w[i + ws] >> bs;
+            if (bs != 0 && i + ws + 1 < _w.size())
+                _w[i] |= _w[i + ws + 1] << (64 - bs);
+        }
+        _w.resize(_w.size() - ws);
+        this->removeTrailingZeros();
+        return *this;
+    }
+
+    F2xelem F2xelem::square() const {
+        std::vector<std::uint64_t> ret(2 * _w.size());
+        for (std::size_t i = 0; i < _w.size(); ++i) {
+            ret[2 * i] = spread(_w[i] & 0xFFFFFFFFULL);
+            ret[2 * i + 1] = spread(_w[i] >> 32);
+        }
+        return F2xelem(std::move(ret));
+    }
+
+    F2xelem F2xelem::squareRoot() const {
+        std::vector<std::uint64_t> ret((_w.size() + 1) / 2);
+        for (std::size_t i = 0; i < _w.size(); ++i)
+            ret[i / 2] |= unspread(_w[i]) << (i % 2 == 0 ? 0 : 32);
+        return F2xelem(std::move(ret));
+    }
+
+    // The coefficient of x^{i-1} is i a_i, i.e. a_i for odd i
+    F2xelem F2xelem::derivative() const {
+        F2xelem ret = *this >> 1;
+        for (auto &w : ret._w)
+            w &= 0x5555555555555555ULL;
+        ret.removeTrailingZeros();
+        return ret;
+    }
+
+    // Same test as Fpxelem::irreducible. x^{2^k} is computed squaring
+    bool F2xelem::irreducible() const {
+        const F2xelem x = monomial(1);
+        F2xelem x2k = x;
+        for (std::size_t i = 0; i < this->deg() / 2; ++i) {
+            x2k = x2k.square() % *this;
+            if (gcd(*this, x2k + x).deg() != 0)
+                return false;
+        }
+        return true;
+    }
+
+    F2xelem operator*(const F2xelem &lhs, const F2xelem &rhs) {
+        const std::vector<std::uint64_t> &a = lhs._w.size() >= rhs._w.size() ? lhs._w : rhs._w;
+        const std::vector<std::uint64_t> &b = lhs._w.size() >= rhs._w.size() ? rhs._w : lhs._w;
+        const std::size_t n = a.size(), m = b.size();
+        if (m == 0)
+            return F2xelem();
+        // a is multiplied by b in blocks of m words. The last one is padded with zeros
+        const std::size_t blocks = (n + m - 1) / m;
+        std::vector<std::uint64_t> r((blocks + 1) * m, 0), buffer(3 * m + scratchWords(m));
+        std::uint64_t *block = buffer.data(), *product = block + m, *scratch = product + 2 * m;
+        for (std::size_t i = 0; i < blocks; ++i) {
+            const std::size_t len = std::min(m, n - i * m);
+            std::copy(a.begin() + i * m, a.begin() + i * m + len, block);
+            std::fill(block + len, block + m, 0);
+            mulWords(product, block, b.data(), m, scratch);
+            for (std::size_t j = 0; j < 2 * m; ++j)
+                r[i * m + j] ^= product[j];
+        }
+        return F2xelem(std::move(r));
+    }
+
+    std::pair<F2xelem, F2xelem> divmod(const F2xelem &lhs, const F2xelem &rhs) {
+        if (rhs._w.empty())
+            throw EOperationUnsupported("Error. Division by zero.");
+        std::pair<F2xelem, F2xelem> ret(F2xelem(), lhs);
+        reduce(ret.second._w, rhs, &ret.first._w);
+        return ret;
+    }
+
+    std::vector<std::pair<F2xelem, std::size_t>> squareFreeFF(F2xelem a) {
+        std::vector<std::pair<F2xelem, std::size_t>> result;
+        const F2xelem one(1);
+        // If a' = 0, c = a and a is a square
+        F2xelem c = gcd(a, a.derivative());
+        F2xelem w = a / c;
+        for (std::size_t i = 1; w != one; ++i) {
+            const F2xelem y = gcd(w, c);
+            const F2xelem z = w / y;
+            if (z.deg() != 0)
+                result.push_back(std::make_pair(z, i));
+            w = y;
+            c /= y;
+        }
+        if (c != one)
+            for (auto &pair : squareFreeFF(c.squareRoot()))
+                result.push_back(std::make_pair(std::move(pair.first), 2 * pair.second));
+        return result;
+    }
+
+    // x^{2^i} is computed squaring, and the factors of degree i are gcd(x^{2^i} - x, pol)
+    std::vector<std::pair<F2xelem, std::size_t>> partialFactorDD(F2xelem pol) {
+        std::vector<std::pair<F2xelem, std::size_t>> result;
+        const F2xelem x = F2xelem::monomial(1), one(1);
+        F2xelem x2i = x;
+        for (std::size_t i = 1; 2 * i <= pol.deg(); ++i) {
+            x2i = x2i.square() % pol;
+            const F2xelem g = gcd(x2i + x, pol);
+            if (g != one) {
+                result.push_back(std::make_pair(g, i));
+                pol /= g;
+                x2i %= pol;
+            }
+        }
+        if (pol != one)
+            result.push_back(std::make_pair(pol, pol.deg()));
+        return result;
+    }
+
+    F2xelem gcd(F2xelem a, F2xelem b) {
+        while (!b._w.empty()) {
+            a %= b;
+            std::swap(a, b);
+        }
+        return a;
+    }
+
+    std::string to_string(const F2xelem &f, char var) {
+        if (f.deg() == 0)
+            return f.coef(0) ? "1" : "0";
+        std::string s;
+        for (std::size_t i = f.deg() + 1; i-- > 1;) {
+            if (!f.coef(i))
+                continue;
+            if (!s.empty())
+                s += "+";
+            s += var;
+            if (i != 1)
+                s += "^" + std::to_string(i);
+        }
+        if (f.coef(0))
+            s += "+1";
+        return s;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const F2xelem &f) {
+        return os << to_string(f);
+    }
+
+    void F2xelem::removeTrailingZeros() {
+        trim(_w);
+    }
+}
@@ -0,0 +1,163 @@
+#ifndef __F2XELEM_HPP
+#define __F2XELEM_HPP
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <ostream>
+#include <string>
+#include <utility>      // std::pair
+#include <vector>
+
+#include "fpelem.hpp"
+#include "exceptions.hpp"
+
+namespace alcp {
+    template<class Integer>
+    class Fpxelem;
+
+    /**
+     * Polynomials over F_2 packed in 64-bit words
+     *
+     * Description:
+     *  The bit j of the word i is the coefficient of x^{64i + j}. There are
+     *   no zero words on top, so the zero polynomial has no words.
+     *  Sums are XORs of words, shifts are shifts of words, products use the
+     *   carry-less kernels of carrylessMul.hpp (Karatsuba on top of them for
+     *   long polynomials), and divisions remove the leading term with a
+     *   shifted XOR of the whole divisor.
+     *  It converts to and from Fpxelem with p = 2, which uses it for the
+     *   irreducibility test and for the square-free and distinct-degree
+     *   factorizations.
+     *
+     * Theoretical background:
+     *  Squaring is linear in characteristic 2: (sum a_i x^i)^2 = sum a_i x^{2i},
+     *   so it just spreads the bits.
+     *  Karatsuba: with X = x^{64k}, (a0 + a1 X)(b0 + b1 X) =
+     *   a0 b0 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) X + a1 b1 X^2
+     *  When one factor is longer, it is split in blocks of the length of
+     *   the other one, and every block is a balanced product.
+     *
+     * Complexity:
+     *  With n and m the number of words:
+     *  Sum: O(n). Product: O(m^{log2(3)-1} n) word products for n >= m.
+     *  Division: O(64 n m). Gcd: O(64 n^2)
+     */
+    class F2xelem {
+    public:
+        // Products with fewer words than this are done by schoolbook
+        static constexpr std::size_t karatsubaWords = 16;
+
+        F2xelem() = default;
+
+        // The constant c mod 2
+        F2xelem(int c);
+
+        explicit F2xelem(std::vector<std::uint64_t> words);
+
+        template<class Integer>
+        explicit F2xelem(const Fpxelem<Integer> &f) {
+#ifndef ALCP_NO_CHECKS
+            if (f.getSize() != 2)
+                throw EOperationUnsupported("The polynomial " + to_string(f) + " is not over F2.");
+#endif
+            for (std::size_t i = 0; i <= f.deg(); ++i)
+                if (f[i] != 0)
+                    this->setCoef(i, true);
+        }
+
+        template<class Integer>
+        explicit operator Fpxelem<Integer>() const {
+            const Fp<Integer> f2(2);
+            std::vector<Fpelem<Integer>> ret(this->deg() + 1, f2.zero());
+            for (std::size_t i = 0; i < ret.size(); ++i)
+                if (this->coef(i))
+                    ret[i] = f2.one();
+            return Fpxelem<Integer>(ret);
+        }
+
+        // x^k
+        static F2xelem monomial(std::size_t k);
+
+        // As in PolynomialRing, the degree of zero is 0
+        std::size_t deg() const;
+
+        bool coef(std::size_t i) const {
+            return i / 64 < _w.size() && ((_w[i / 64] >> (i % 64)) & 1) != 0;
+        }
+
+        void setCoef(std::size_t i, bool c);
+
+        const std::vector<std::uint64_t> &words() const { return _w; }
+
+        F2xelem &operator+=(const F2xelem &rhs);
+
+        // In characteristic 2, a - b = a + b
+        F2xelem &operator-=(const F2xelem &rhs) { return *this += rhs; }
+
+        F2xelem operator-() const { return *this; }
+
+        F2xelem &operator*=(const F2xelem &rhs) { return *this = *this * rhs; }
+
+        F2xelem &operator/=(const F2xelem &rhs) { return *this = divmod(*this, rhs).first; }
+
+        F2xelem &operator%=(const F2xelem &rhs);
+
+        // Multiplication and division by x^k
+        F2xelem &operator<<=(std::size_t k);
+
+        F2xelem &operator>>=(std::size_t k);
+
+        F2xelem square() const;
+
+        // Inverse of square(). The odd coefficients must be zero
+        F2xelem squareRoot() const;
+
+        F2xelem derivative() const;
+
+        bool irreducible() const;
+
+        friend F2xelem operator+(F2xelem lhs, const F2xelem &rhs) { return lhs += rhs; }
+
+        friend F2xelem operator-(F2xelem lhs, const F2xelem &rhs) { return lhs += rhs; }
+
+        friend F2xelem operator*(const F2xelem &lhs, const F2xelem &rhs);
+
+        friend F2xelem operator/(const F2xelem &lhs, const F2xelem &rhs) { return divmod(lhs, rhs).first; }
+
+        friend F2xelem operator%(F2xelem lhs, const F2xelem &rhs) { return lhs %= rhs; }
+
+        friend F2xelem operator<<(F2xelem lhs, std::size_t k) { return lhs <<= k; }
+
+        friend F2xelem operator>>(F2xelem lhs, std::size_t k) { return lhs >>= k; }
+
+        // Quotient and remainder
+        friend std::pair<F2xelem, F2xelem> divmod(const F2xelem &lhs, const F2xelem &rhs);
+
+        friend F2xelem gcd(F2xelem a, F2xelem b);
+
+        // Square-free factorization of a != 0, as squareFreeFF in factorizationFq.hpp:
+        //  pairs (z, i) with a = prod z^i and the z square-free and coprime
+        friend std::vector<std::pair<F2xelem, std::size_t>> squareFreeFF(F2xelem a);
+
+        // Distinct-degree factorization of a square-free pol, as partialFactorDD in
+        //  factorizationFq.hpp: pairs (g, i) with g the product of the factors of degree i
+        friend std::vector<std::pair<F2xelem, std::size_t>> partialFactorDD(F2xelem pol);
+
+        friend bool operator==(const F2xelem &lhs, const F2xelem &rhs) { return lhs._w == rhs._w; }
+
+        friend bool operator!=(const F2xelem &lhs, const F2xelem &rhs) { return !(lhs == rhs); }
+
+        friend std::string to_string(const F2xelem &f, char var);
+
+        friend std::string to_string(const F2xelem &f) { return to_string(f, 'x'); }
+
+        friend std::ostream &operator<<(std::ostream &os, const F2xelem &f);
+
+    private:
+        void removeTrailingZeros();
+
+        std::vector<std::uint64_t> _w;
+    };
+}
+
+#endif // __F2XELEM_HPP
@@ -10,7 +10,11 @@
 
 #include "fpxelem.hpp"
 #include "fqxelem.hpp"
+#include "f2mxelem.hpp"
+#include "f2xelem.hpp"
+#include "staticFpxelem.hpp"
 #include "generalPurpose.hpp"
+#include "preparedMultiplier.hpp"
 #include "types.hpp"
 namespace alcp {
     /* Detalles de la implementación:
@@ -58,6 +62,23 @@ namespace alcp {
     template<typename Fxelem>
     matrix<typename Fxelem::Felem> formMatrix(const Fxelem &pol);
 
+    // Polynomials over F_2 are factored as F2xelem, i.e. as packed bits. part is squareFreeFF or
+    //  partialFactorDD for F2xelem. It returns false (and does nothing) for other polynomials
+    template<typename Fxelem, typename Part>
+    bool factorAsF2xelem(const Fxelem &, std::vector<std::pair<Fxelem, std::size_t> > &, Part) {
+        return false;
+    }
+
+    template<typename Integer, typename Part>
+    bool factorAsF2xelem(const Fpxelem<Integer> &a, std::vector<std::pair<Fpxelem<Integer>, std::size_t> > &result,
+                         Part part) {
+        if (a.getSize() != 2)
+            return false;
+        for (auto &pair : part(F2xelem(a)))
+            result.push_back(std::make_pair(static_cast<Fpxelem<Integer>>(pair.first), pair.second));
+        return true;
+    }
+
 //Part I
 //Outputs a vector of pairs with the factors and multiplicities of the square free factorization (not necesarily sorted by multiplicity)
 /*
@@ -67,6 +88,8 @@ namespace alcp {
     std::vector<std::pair<Fxelem, std::size_t> > squareFreeFF(Fxelem a) {
         std::size_t i = 1;
         std::vector<std::pair<Fxelem, std::size_t> > result;
+        if (factorAsF2xelem(a, result, [](const F2xelem &f) { return squareFreeFF(f); }))
+            return result;
 
         Fxelem b = a.derivative();
         if (b != 0) {
@@ -84,15 +107,16 @@ namespace alcp {
             if (c != 1) {
                 big_int p = c.getField().getP();
                 // c is now of the form: c_0 + c_p x^p + ... c_{kp} x^{kp}
-                big_int exponent = fastPow(p, c.getField().getM() - 1);
                 //This for computes c = c^{1/p}
                 std::vector<typename Fxelem::Felem> rootPOfC;
-                for (std::size_t j = 0; j <= c.deg(); j += static_cast<std::size_t>(p))
-                    if (c[j] != 0)
-                        rootPOfC.push_back(fastPow(c[j], exponent));
+                for (std::size_t j = 0; j <= c.deg(); j += static_cast<std::size_t>(p)) {
+                    const typename Fxelem::Felem cj = c[j];
+                    if (cj != 0)
+                        rootPOfC.push_back(pthRoot(cj));
                     else {
-                        rootPOfC.push_back(getZero(c[j]));
+                        rootPOfC.push_back(getZero(cj));
                     }
+                }
                 auto aux = squareFreeFF(Fxelem(rootPOfC));
 
                 for (auto &pair: aux) {
@@ -107,15 +131,16 @@ namespace alcp {
         }
         else { // a is of the form: a_0 + a_p x^p + ... a_{kp} x^{kp} (because its derivative is zero)
             big_int p = a.getField().getP();
-            big_int exponent = fastPow(p, a.getField().getM() - 1);
             //This for computes a = a^{1/p}
             std::vector<typename Fxelem::Felem> rootPOfA;
-            for (std::size_t j = 0; j <= a.deg(); j += static_cast<std::size_t>(p))
-                if (a[j] != 0)
-                    rootPOfA.push_back(fastPow(a[j], exponent));
+            for (std::size_t j = 0; j <= a.deg(); j += static_cast<std::size_t>(p)) {
+                const typename Fxelem::Felem aj = a[j];
+                if (aj != 0)
+                    rootPOfA.push_back(pthRoot(aj));
                 else {
-                    rootPOfA.push_back(getZero(a[j]));
+                    rootPOfA.push_back(getZero(aj));
                 }
+            }
             auto aux = squareFreeFF(Fxelem(rootPOfA));
 
             for (auto &pair: aux) {
@@ -139,6 +164,8 @@ namespace alcp {
     std::vector<std::pair<Fxelem, std::size_t> > partialFactorDD(Fxelem pol) {
     	//result[i].first will be a product of irreducible polynomials with degree result[i].second
     	std::vector<std::pair<Fxelem, std::size_t> > result;
+        if (factorAsF2xelem(pol, result, [](const F2xelem &f) { return partialFactorDD(f); }))
+            return result;
 
     	int n = pol.deg();
     	if (n == 1){
@@ -150,6 +177,7 @@ namespace alcp {
 
         //first iteration is performed out of the loop because we have r in mat (there is no need to compute it again)
         std::vector<typename Fxelem::Felem> r = mat[1];
+        const PreparedMatrix<typename Fxelem::Felem> preparedMat(mat);
 
 
         std::size_t i = 1;
@@ -163,13 +191,7 @@ namespace alcp {
 
         ++i;
         while (i <= pol.deg() / 2) {
-            std::vector<typename Fxelem::Felem> aux = r;
-            for (int j = 0; j < n; ++j) {
-                r[j] = aux[0] * mat[0][j];
-                for (int k = 1; k < n; ++k) {
-                    r[j] += aux[k] * mat[k][j];
-                }
-            }//This is just r = r*mat;
+            r = preparedMat.mulLeft(r);
             r[1] -= 1;
             result.push_back(std::make_pair(gcd(Fxelem(r), pol),
                                             i));//gcd (a_1, w (mod a)) = gcd (a_1, w (mod a_1)) where a_1 divides a (because (w (mod a))(mod a_1) = w (mod a_1))
@@ -186,6 +208,16 @@ namespace alcp {
         return result;
     }
 
+    // -pol_0, ..., -pol_n, ready to be multiplied many times. Used to reduce x*r (mod pol)
+    template<typename Fxelem>
+    std::vector<PreparedMultiplier<typename Fxelem::Felem>> preparedMinusCoefficients(const Fxelem &pol) {
+        std::vector<PreparedMultiplier<typename Fxelem::Felem>> ret;
+        ret.reserve(pol.deg() + 1);
+        for (const auto &coef : pol)
+            ret.emplace_back(-coef);
+        return ret;
+    }
+
     template<typename Fxelem>
     void fastPowModPol(Fxelem &a, big_int b, std::vector<Fxelem> pwrsX, int deg) {
         if (b == 0) {
@@ -199,7 +231,7 @@ namespace alcp {
                     aux *= aux;
                     for (int i = 0; i <= (int) (aux.deg()) - deg; ++i) {//aux.deg is always <= 2*deg-2
                         if (aux[i + deg] != 0)
-                            aux += Fxelem(aux[i + deg]) * pwrsX[i];
+                            aux += scale(pwrsX[i], aux[i + deg]);
                     }
                     b /= 2;
                 }
@@ -207,7 +239,7 @@ namespace alcp {
                     a *= aux;
                     for (int i = 0; i <= (int) (a.deg()) - deg; ++i) {//a.deg is always <= 2*deg-2
                         if (a[i + deg] != 0)
-                            a += Fxelem(a[i + deg]) * pwrsX[i];
+                            a += scale(pwrsX[i], a[i + deg]);
                     }
                     b -= 1;
                 }
@@ -215,18 +247,28 @@ namespace alcp {
         }
     }
 
-    template<class Integer>
-    Fpxelem<Integer> randomPol(const Fp<Integer> & field, std::size_t degree){
+    // Random coefficients of a polynomial of the given degree over a prime field
+    template<class Field>
+    auto randomCoefficients(const Field & field, std::size_t degree){
     	//TODO esto genera números aleatorios de 64, parece suficiente, pero si q es mayor que 2^63 en realidad no lo es...
-		std::vector<Fpelem<Integer> > r(degree+1);
+		std::vector<decltype(field.get(0))> r(degree+1);
 		std::mt19937_64 generator(std::chrono::system_clock::now().time_since_epoch().count());
-        std::uniform_int_distribution<int> distr(0, static_cast<int>(field.getP())-1);
 		for (std::size_t i = 0; i <= degree; ++i) {
 			r[i]=(field.get(generator()));
 		}
 		return r;
     }
 
+    template<class Integer>
+    Fpxelem<Integer> randomPol(const Fp<Integer> & field, std::size_t degree){
+		return randomCoefficients(field, degree);
+    }
+
+    template<long long P>
+    StaticFpxelem<P> randomPol(const StaticFp<P> & field, std::size_t degree){
+		return randomCoefficients(field, degree);
+    }
+
     template<class Integer>
     Fqxelem<Integer> randomPol(const Fq<Integer> & field, std::size_t degree){
 		std::vector<Fqelem<Integer>> r(degree+1);
@@ -237,6 +279,16 @@ namespace alcp {
 		return r;
     }
 
+    template<class Integer>
+    F2mxelem<Integer> randomPol(const F2m<Integer> & field, std::size_t degree){
+		std::vector<F2melem<Integer>> r(degree+1);
+		std::size_t d = field.getM()-1;
+		for (size_t i = 0; i <= degree; ++i) {
+			r[i]=field.get(randomPol(field.getBaseField(), d));
+		}
+		return r;
+    }
+
 
 
 //Part III
@@ -251,18 +303,17 @@ namespace alcp {
             factors.push_back(pol);
             return factors;
         }
-        int m = polDeg / n;
-
         std::vector<Fxelem> pwrsX;
+        const auto minusPol = preparedMinusCoefficients(pol);
         std::vector<typename Fxelem::Felem> r(2 * polDeg - 1, getZero(pol.lc()));
         r[polDeg - 1] = 1; //r == (0, 0, ..., 1)
         for (int i = polDeg; i <= 2 * polDeg - 2; ++i) {
             // r = (-r_{n-1}*pol_0, r_0 -r_{n-1}*pol_1,..., r_{n-2}-r_{n-1}*pol_{n-1})
             auto aux = r[polDeg - 1];
             for (std::size_t j = polDeg - 1; j >= 1; --j) {
-                r[j] = r[j - 1] - aux * pol[j];
+                r[j] = r[j - 1] + minusPol[j].mul(aux);
             }
-            r[0] = -aux * pol[0];
+            r[0] = minusPol[0].mul(aux);
             r[i] = -1;
             pwrsX.push_back(Fxelem(r));
             r[i] = 0;
@@ -271,13 +322,17 @@ namespace alcp {
         while (true) {
             Fxelem v = randomPol(pol.getField(), 2 * n - 1);
             if (pol.getField().getSize() % 2 == 0) {//size %2 == 0 iff p %2 == 0
+                // v + v^2 + ... + v^{2^{kn-1}} for q = 2^k, the trace of F_{q^n} over F_2
+                std::size_t k = 0;
+                for (auto q = pol.getField().getSize(); q > 1; q /= 2)
+                    ++k;
                 Fxelem aux = v;
-                for (int i = 1; i <= n * m - 1; ++i) {
+                for (std::size_t i = 1; i <= n * k - 1; ++i) {
                     aux *= aux;
                     //This loop performs the operation (mod pol)
                     for (int i = polDeg; i <= aux.deg(); ++i) {//aux.deg is always <= 2*polDeg-2
                         if (aux[i] != 0)
-                            aux += Fxelem(aux[i]) * pwrsX[i - polDeg];
+                            aux += scale(pwrsX[i - polDeg], aux[i]);
                     }
                     v += aux;
                 }
@@ -316,13 +371,14 @@ namespace alcp {
         matrix<typename Fxelem::Felem> result;
        
         result.push_back(r);
+        const auto minusPol = preparedMinusCoefficients(pol);
         for (big_int i = 1; i <= (n - 1) * q; ++i) { 
             // r = (-r_{n-1}*pol_0, r_0 -r_{n-1}*pol_1,..., r_{n-2}-r_{n-1}*pol_{n-1})
             auto aux = r[n - 1];
             for (std::size_t j = n - 1; j >= 1; --j) {
-                r[j] = r[j - 1] - aux * pol[j];
+                r[j] = r[j - 1] + minusPol[j].mul(aux);
             }
-            r[0] = -aux * pol[0];
+            r[0] = minusPol[0].mul(aux);
             if (i % q == 0)
                 result.push_back(r);
         }
@@ -340,6 +396,7 @@ namespace alcp {
 			return result;
 
 		std::vector<Fxelem> pwrsX;
+        const auto minusPol = preparedMinusCoefficients(pol);
 
         std::vector<typename Fxelem::Felem> r(2 * polDeg - 1, getZero(pol.lc()));
         r[polDeg - 1] = 1; //r == (0, 0, ..., 1)
@@ -347,9 +404,9 @@ namespace alcp {
             // r = (-r_{n-1}*pol_0, r_0 -r_{n-1}*pol_1,..., r_{n-2}-r_{n-1}*pol_{n-1})
             auto aux = r[polDeg - 1];
             for (int j = polDeg - 1; j >= 1; --j) {
-                r[j] = r[j - 1] - aux * pol[j];
+                r[j] = r[j - 1] + minusPol[j].mul(aux);
             }
-            r[0] = -aux * pol[0];
+            r[0] = minusPol[0].mul(aux);
             r[i] = -1;
             pwrsX.push_back(Fxelem(r));
             r[i] = 0;
@@ -365,7 +422,7 @@ namespace alcp {
 			 aux = aux*xq; //(x^{i*q});
 			for (int j = 0; j <= (int) (aux.deg()) - polDeg; ++j) {//At this point result[i].deg is always <= 2*deg-2
        			if (aux[j + polDeg] != 0)
-       	      		aux += Fxelem(aux[j + polDeg]) * pwrsX[j];
+       	      		aux += scale(pwrsX[j], aux[j + polDeg]);
       		 }
 			auto aux2 = static_cast<std::vector<typename Fxelem::Felem> >(aux);
 		    aux2.resize(polDeg, getZero(pol.lc()));
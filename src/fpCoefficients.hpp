@@ -0,0 +1,48 @@
+#ifndef __FP_COEFFICIENTS_HPP
+#define __FP_COEFFICIENTS_HPP
+
+#include <cstddef>      // std::size_t
+
+#include "fpelem.hpp"
+#include "polRing.hpp"  // CoefficientStorage
+#include "packedCoefficients.hpp"
+
+namespace alcp {
+    // An element of F_p is stored as its residue
+    template<class Integer>
+    struct CoefficientPacking<Fpelem<Integer>> {
+        using Word = Integer;
+        using Context = FpContext<Integer>;
+
+        static std::size_t width(const Context *) { return 1; }
+
+        static const Context *context(const Fpelem<Integer> &e) { return e.mod(); }
+
+        static const Fpelem<Integer> &zero(const Context *ctx) { return ctx->zero; }
+
+        static Fpelem<Integer> read(const Context *ctx, const Integer *w) {
+            Fpelem<Integer> ret(ctx->zero);
+            ret._num = *w;
+            return ret;
+        }
+
+        static void write(Integer *w, const Fpelem<Integer> &e) { *w = e._num; }
+    };
+
+    /**
+     * Coefficients of a polynomial over F_p
+     *
+     * The context of the field once and one residue per coefficient, so
+     *  data() is the array of residues.
+     */
+    template<class Integer>
+    using FpCoefficients = PackedCoefficients<Fpelem<Integer>>;
+
+    // Polynomials over F_p store their coefficients as a FpCoefficients
+    template<class Integer>
+    struct CoefficientStorage<Fpelem<Integer>> {
+        using type = FpCoefficients<Integer>;
+    };
+}
+
+#endif // __FP_COEFFICIENTS_HPP
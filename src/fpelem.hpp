@@ -4,60 +4,63 @@
 #include <string>
 #include <vector>
 #include <cctype>
+#include <map>
+#include <memory>       // std::unique_ptr
+#include <mutex>
 
 #include "types.hpp"
 #include "exceptions.hpp"
 #include "zelem.hpp"            // to_string
 #include "generalPurpose.hpp"   // millerRabin
+#include "modArith.hpp"         // Modulus
 #include "quotientRing.hpp"
 
 namespace alcp {
     template<class Integer>
     class Fpelem;
 
+    template<class Integer>
+    struct FpContext;
+
     template<class Integer = big_int>
     class Fp {
     static_assert(is_integral<Integer>::value, "Type is not a supported integer.");
 
     public:
-        Fp(Integer p) : _p(p) {
-            if (_p <= 0 || !millerRabin(_p))
-                throw EpNotPrime("Could not create F" + to_string(_p) + ". " + to_string(_p) + " is not prime.");
-        }
+        Fp(Integer p) : _ctx(FpContext<Integer>::intern(p)) { }
 
         Fp(const Fp<Integer> &f) = default;
 
         Fpelem<Integer> get(Integer n) const {
-            n %= _p;
-            if (n < 0)
-                n += _p;
-            return Fpelem<Integer>(n, _p);
+            return Fpelem<Integer>(_ctx->mod.reduce(n), _ctx);
         }
 
+        const Fpelem<Integer> &zero() const { return _ctx->zero; }
+
+        const Fpelem<Integer> &one() const { return _ctx->one; }
 
-        Integer mod() const { return _p; }
+        Integer mod() const { return _ctx->p; }
 
-        Integer getSize() const { return _p; }
+        Integer getSize() const { return _ctx->p; }
 
-        Integer getP() const { return _p; }
+        Integer getP() const { return _ctx->p; }
 
         std::size_t getM() const { return 1; }
 
         std::vector<Fpelem<Integer>> getElems() const {
-            std::vector<Fpelem<Integer>> ret(static_cast<std::size_t>(_p));
-            for (std::size_t i = 0; i < _p; ++i)
+            std::vector<Fpelem<Integer>> ret(static_cast<std::size_t>(this->getP()));
+            for (std::size_t i = 0; i < ret.size(); ++i)
                 ret[i] = this->get(i);
             return ret;
         }
 
+        // Fields are interned, so two fields are equal iff they share the context
+        bool operator==(const Fp &rhs) const { return _ctx == rhs._ctx; }
 
-
-        bool operator==(const Fp &rhs) const { return _p == rhs._p; }
-
-        bool operator!=(const Fp &rhs) const { return _p != rhs._p; }
+        bool operator!=(const Fp &rhs) const { return _ctx != rhs._ctx; }
 
         friend std::string to_string(const Fp<Integer> &f) {
-            return "F" + to_string(f._p);
+            return "F" + to_string(f.getP());
         }
 
         friend std::ostream &operator<<(std::ostream &os, Fp<Integer> e) {
@@ -66,22 +69,22 @@ namespace alcp {
         }
 
     private:
-        Integer _p;
+        const FpContext<Integer> *_ctx;
 
         friend class Fpelem<Integer>;
 
-        // Small hack to let Fpelem create an Fp fast without memoization
-        Fp(Integer p, bool) : _p(p) { }
+        // Small hack to let Fpelem create an Fp fast from its context
+        Fp(const FpContext<Integer> *ctx, bool) : _ctx(ctx) { }
 
     };
 
 
     template<class Integer>
-    class Fpelem : public QuotientRing<Fpelem, Integer, Integer> {
+    class Fpelem : public QuotientRing<Fpelem, Integer, Integer, const FpContext<Integer> *> {
     private:
         // ::alcp::Fpelem still necessary for clang 3.9
         // http://stackoverflow.com/questions/17687459/clang-not-accepting-use-of-template-template-parameter-when-using-crtp
-        using FBase = QuotientRing<::alcp::Fpelem, Integer, Integer>;
+        using FBase = QuotientRing<::alcp::Fpelem, Integer, Integer, const FpContext<Integer> *>;
 
     public:
         using F = Fp<Integer>;
@@ -94,7 +97,7 @@ namespace alcp {
         Fpelem & operator=(const Fpelem & e)  = default;
         Fpelem & operator=(Fpelem && e)  = default;
 
-        F getField() const{ return F(this->_mod, true); }
+        F getField() const{ return F(this->mod(), true); }
 
         friend std::string to_string(const Fpelem &e) {
             return to_string(e._num);
@@ -104,11 +107,102 @@ namespace alcp {
             return "+" + to_string(e);
         }
 
+        // The Frobenius map is the identity on F_p
+        friend Fpelem frobenius(const Fpelem &e, std::size_t = 1) { return e; }
+
+        friend Fpelem pthRoot(const Fpelem &e) { return e; }
+
     private:
         template <class>
             friend class Fp;
+        template <class>
+            friend struct FpContext;
+        // They read and write the residues of the coefficients
+        template <class>
+            friend class Fpxelem;
+        template <class>
+            friend struct CoefficientPacking;
+        // The elements of F_q are stored as residues over F_p
+        template <class>
+            friend struct FqContext;
+    };
+
+    /**
+     * Shared data of the field F_p
+     *
+     * There is exactly one context per prime. It is created the first time
+     *  an Fp is built for that prime (which is the only time the primality
+     *  test is run) and it lives until the end of the program, so elements
+     *  can refer to it through a plain pointer. This makes compatible() and
+     *  Fp::operator== a pointer comparison and keeps an Fpelem two words long.
+     */
+    template<class Integer>
+    struct FpContext {
+        Integer p;
+        // Precomputed constants to reduce modulo p
+        Modulus<Integer> mod;
+        Fpelem<Integer> zero, one;
+
+        static const FpContext *intern(const Integer &p) {
+            static std::mutex lock;
+            static std::map<Integer, std::unique_ptr<FpContext>> registry;
+
+            std::lock_guard<std::mutex> guard(lock);
+            auto it = registry.find(p);
+            if (it != registry.end())
+                return it->second.get();
+            if (p <= 0 || !millerRabin(p))
+                throw EpNotPrime("Could not create F" + to_string(p) + ". " + to_string(p) + " is not prime.");
+            std::unique_ptr<FpContext> ctx(new FpContext(p));
+            return (registry[p] = std::move(ctx)).get();
+        }
+
+    private:
+        explicit FpContext(const Integer &prime) :
+                p(prime), mod(prime), zero(Integer(0), this), one(Integer(1), this) { }
+    };
+
+    // An Fpelem<Int> becomes an Fpelem<Integer> in the context of the same prime
+    template<class Integer>
+    struct ModulusConversion<const FpContext<Integer> *, Integer> {
+        template<class Quot, class Int>
+        static const FpContext<Integer> *convert(const FpContext<Int> *ctx) {
+            return FpContext<Integer>::intern(static_cast<Integer>(ctx->p));
+        }
     };
 
+    // Modular operations for the elements of F_p, which only store their context
+    template<class Int>
+    Int addMod(const Int &a, const Int &b, const FpContext<Int> *ctx) { return ctx->mod.add(a, b); }
+
+    template<class Int>
+    Int subMod(const Int &a, const Int &b, const FpContext<Int> *ctx) { return ctx->mod.sub(a, b); }
+
+    template<class Int>
+    Int negMod(const Int &a, const FpContext<Int> *ctx) { return ctx->mod.neg(a); }
+
+    template<class Int>
+    Int mulMod(const Int &a, const Int &b, const FpContext<Int> *ctx) { return ctx->mod.mul(a, b); }
+
+    template<class Int>
+    Int invMod(const Int &a, const FpContext<Int> *ctx) { return ctx->mod.inv(a); }
+
+    template<class Int>
+    auto reduceWideMod(uint128_t x, const FpContext<Int> *ctx) -> decltype(reduceWideMod(x, ctx->mod)) {
+        return reduceWideMod(x, ctx->mod);
+    }
+
+    template<class Int>
+    auto shoupConstantMod(const Int &w, const FpContext<Int> *ctx) -> decltype(shoupConstantMod(w, ctx->mod)) {
+        return shoupConstantMod(w, ctx->mod);
+    }
+
+    template<class Int>
+    auto shoupMulMod(const Int &a, const Int &w, std::uint64_t wShoup, const FpContext<Int> *ctx)
+            -> decltype(shoupMulMod(a, w, wShoup, ctx->mod)) {
+        return shoupMulMod(a, w, wShoup, ctx->mod);
+    }
+
     using Fpelem_b = Fpelem<big_int>;
     using Fp_b = Fp<big_int>;
 
@@ -2,18 +2,35 @@
 #ifndef __FPXELEM_HPP
 #define __FPXELEM_HPP
 
-#include <algorithm>    // std::transform
+#include <algorithm>    // std::transform, std::max
+#include <cstdint>      // std::uint64_t
+#include <type_traits>  // std::is_same
+#include <utility>      // std::pair
 #include <vector>
 
 #include "types.hpp"
 #include "fpelem.hpp"
 #include "zxelem.hpp"
 #include "polRing.hpp"
+#include "fpCoefficients.hpp"
+#include "simdKernels.hpp"
+#include "f2xelem.hpp"
+#include "ntt.hpp"
 
 namespace alcp {
     template<class Integer>
     class Zxelem;
 
+    template<class Integer>
+    class Fpxelem;
+
+    // Measured with p = 2^31 - 1. The lazy reduction of Accumulator makes the
+    //  schoolbook product competitive up to a few dozens of coefficients
+    template<>
+    struct KaratsubaThreshold<Fpxelem> {
+        static constexpr std::size_t value = 48;
+    };
+
     template<class Integer>
     class Fpxelem : public PolynomialRing<Fpxelem, Fpelem<Integer>, Integer> {
     private:
@@ -26,6 +43,15 @@ namespace alcp {
         using F = Fp<Integer>;
         using Felem = Fpelem<Integer>;
 
+        // Products where both factors have at least this number of coefficients
+        //  use the NTT when p < ntt::modulusBound, with one transform modulo p
+        //  if p = c 2^k + 1 or three transforms and the CRT otherwise
+        static constexpr std::size_t nttThreshold = 128;
+        static constexpr std::size_t nttCrtThreshold = 1024;
+        // NewtonDivisionThreshold when the products of the division are one
+        //  NTT modulo p, measured with p = 998244353
+        static constexpr std::size_t nttNewtonThreshold = 1024;
+
         // Inherit ctors
         using FBase::FBase;
 
@@ -44,6 +70,9 @@ namespace alcp {
         Fpxelem(const Zxelem<Integer> &e, Integer p) : FBase{Fpxelem{e, Fp<Integer>(p)}}{}
 
         bool irreducible() const {
+            // Over F_2 the test runs on the packed bits
+            if (this->getSize() == 2)
+                return F2xelem(*this).irreducible();
             Fpxelem x(std::vector<Fpelem<Integer>>{getZero(this->lc()), getOne(this->lc())});
             Fpxelem xpk = x; // x^(p^k)
 
@@ -55,6 +84,117 @@ namespace alcp {
             return true;
         }
 
+        // For p < 2^31 the coefficient-wise operations are done with the
+        //  vectorized kernels of simdKernels.hpp directly on the residues
+        Fpxelem &operator+=(const Fpxelem &rhs) {
+            if (!this->useKernels())
+                return FBase::operator+=(rhs);
+#ifndef ALCP_NO_CHECKS
+            checkCompatible(rhs, "Polynomials not in the same ring. Error when adding the polynomials.");
+#endif
+            if (this->_v.size() < rhs._v.size())
+                this->_v.resize(rhs._v.size());
+            simd::add(words(this->_v.data()), words(this->_v.data()), words(rhs._v.data()),
+                      rhs._v.size(), this->modulus());
+            this->removeTrailingZeros();
+            return *this;
+        }
+
+        Fpxelem &operator-=(const Fpxelem &rhs) {
+            if (!this->useKernels())
+                return FBase::operator-=(rhs);
+#ifndef ALCP_NO_CHECKS
+            checkCompatible(rhs, "Polynomials not in the same ring. Error when subtracting the polynomials.");
+#endif
+            if (this->_v.size() < rhs._v.size())
+                this->_v.resize(rhs._v.size());
+            simd::sub(words(this->_v.data()), words(this->_v.data()), words(rhs._v.data()),
+                      rhs._v.size(), this->modulus());
+            this->removeTrailingZeros();
+            return *this;
+        }
+
+        using FBase::operator-;
+
+        Fpxelem operator-() const {
+            if (!this->useKernels())
+                return FBase::operator-();
+            Fpxelem ret(*this);
+            simd::neg(words(ret._v.data()), words(ret._v.data()), ret._v.size(), this->modulus());
+            return ret;
+        }
+
+        using FBase::operator*=;
+
+        Fpxelem &operator*=(const Fpxelem &rhs) {
+            const std::size_t n = this->_v.size(), m = rhs._v.size();
+            if (!this->useNtt(n, m))
+                return FBase::operator*=(rhs);
+#ifndef ALCP_NO_CHECKS
+            checkCompatible(rhs, "Polynomials not in the same ring. Error when multiplying the polynomials.");
+#endif
+            // A square goes with a single forward transform
+            std::vector<std::uint64_t> a(n), b;
+            for (std::size_t i = 0; i < n; ++i)
+                a[i] = this->residue(this->_v.data()[i]);
+            const bool square = this == &rhs;
+            if (!square) {
+                b.resize(m);
+                for (std::size_t i = 0; i < m; ++i)
+                    b[i] = this->residue(rhs._v.data()[i]);
+            }
+            std::vector<std::uint64_t> r(n + m - 1);
+            ntt::mul(r.data(), a.data(), n, square ? a.data() : b.data(), m, this->residue(this->getSize()));
+            this->_v.resize(n + m - 1);
+            for (std::size_t i = 0; i < r.size(); ++i)
+                this->_v.data()[i] = static_cast<Integer>(static_cast<long long>(r[i]));
+            this->removeTrailingZeros();
+            return *this;
+        }
+
+        // Product by a scalar
+        Fpxelem &operator*=(const Fpelem<Integer> &c) {
+#ifndef ALCP_NO_CHECKS
+            if (!compatible(this->lc(), c))
+                throw EOperationUnsupported("Error when multiplying " + to_string(*this) + " by " +
+                                            to_string(c) + ". They are not in the same field.");
+#endif
+            if (!this->useKernels())
+                return *this *= Fpxelem(c);
+            simd::scale(words(this->_v.data()), words(this->_v.data()), this->_v.size(),
+                        static_cast<long long>(c._num), this->modulus());
+            this->removeTrailingZeros();
+            return *this;
+        }
+
+        friend Fpxelem operator*(const Fpelem<Integer> &lhs, const Fpxelem &rhs) {
+            return Fpxelem(rhs) *= lhs;
+        }
+
+        friend Fpxelem operator*(const Fpxelem &lhs, const Fpelem<Integer> &rhs) {
+            return Fpxelem(lhs) *= rhs;
+        }
+
+        Fpelem<Integer> eval(const Fpelem<Integer> &a) const {
+            if (!this->useKernels())
+                return FBase::eval(a);
+            Fpelem<Integer> ret(a);
+            ret._num = static_cast<Integer>(simd::horner(words(this->_v.data()), this->_v.size(),
+                                                         static_cast<long long>(a._num), this->modulus()));
+            return ret;
+        }
+
+        using FBase::div2;
+
+        // The products of the Newton iteration cost the most when they are
+        //  computed with the CRT, so only NTT primes lower the threshold
+        std::pair<Fpxelem, Fpxelem> div2(const Fpxelem &divisor) const {
+            if (this->deg() >= divisor.deg() && this->getSize() < Integer(ntt::modulusBound) &&
+                ntt::direct(residue(this->getSize()), this->deg() - divisor.deg() + 1, divisor.deg() + 1))
+                return FBase::div2(*this, divisor, nttNewtonThreshold);
+            return FBase::div2(*this, divisor, NewtonDivisionThreshold<::alcp::Fpxelem>::value);
+        }
+
         const Fp<Integer> getField() const {
             return this->lc().getField();
         }
@@ -108,6 +248,44 @@ namespace alcp {
         friend bool operator!=(Integer lhs, const Fpxelem<Integer> &rhs) {
             return !(rhs == lhs);
         }
+
+    private:
+        // The kernels work on residues stored in long long
+        bool useKernels() const {
+            return std::is_same<Integer, long long>::value &&
+                   static_cast<std::uint64_t>(this->getSize()) < simd::modulusBound;
+        }
+
+        long long modulus() const { return static_cast<long long>(this->getSize()); }
+
+        bool useNtt(std::size_t n, std::size_t m) const {
+            if (std::min(n, m) < nttThreshold || this->getSize() >= Integer(ntt::modulusBound))
+                return false;
+            return std::min(n, m) >= nttCrtThreshold || ntt::direct(residue(this->getSize()), n, m);
+        }
+
+        static std::uint64_t residue(const Integer &n) {
+            return static_cast<std::uint64_t>(static_cast<long long>(n));
+        }
+
+        static long long *words(long long *r) { return r; }
+
+        static const long long *words(const long long *r) { return r; }
+
+        // Never called, useKernels() is false for these types
+        template<class T>
+        static long long *words(T *) { return nullptr; }
+
+        template<class T>
+        static const long long *words(const T *) { return nullptr; }
+
+#ifndef ALCP_NO_CHECKS
+        void checkCompatible(const Fpxelem &rhs, std::string &&error) const {
+            if (!compatible(*this, rhs))
+                throw EOperationUnsupported(error + "\nThe values that caused it were " + to_string(*this) +
+                                            " and " + to_string(rhs) + ".");
+        }
+#endif
     };
 
     using Fpxelem_b = Fpxelem<big_int>;
@@ -1,7 +1,16 @@
 #ifndef __FQELEM_HPP
 #define __FQELEM_HPP
 
+#include <algorithm>    // std::equal, std::lexicographical_compare, std::min
+#include <map>
+#include <memory>       // std::unique_ptr, std::shared_ptr, std::make_shared, std::uninitialized_fill_n
+#include <new>          // placement new
+#include <mutex>
+#include <random>
+#include <tuple>
+#include <cstdint>
 #include <type_traits>
+#include <utility>      // std::pair
 #include <vector>
 #include <stdexcept>
 
@@ -9,6 +18,10 @@
 #include "zelem.hpp"
 #include "fpelem.hpp"
 #include "fpxelem.hpp"
+#include "accumulator.hpp"
+#include "berlekampMassey.hpp"
+#include "diskCache.hpp"
+#include "preparedMultiplier.hpp"
 #include "generalPurpose.hpp"
 #include "types.hpp"
 #include "exceptions.hpp"
@@ -17,71 +30,324 @@ namespace alcp {
     template<class Integer>
     class Fqelem;
 
-    template<class Integer = big_int>
-    class Fq {
-    static_assert(is_integral<Integer>::value, "Type is not a supported integer.");
+    template<class Integer>
+    struct FqContext;
+
+    template<class Integer>
+    class Fqxelem;
+
+    /**
+     * Blocks of residues of the elements of the extensions of big degree
+     *
+     * Description:
+     *  The elements of F_q keep being created and destroyed, so the blocks of
+     *   the ones that do not fit inline in FqResidues are not given back to
+     *   the heap. Up to maxFree blocks of every size are kept in a free list
+     *   of the thread, and new elements take them from there.
+     *  A block may be freed by another thread than the one that allocated it.
+     *
+     * Complexity:
+     *  O(log(number of sizes in use)) to allocate and to free a block once
+     *   the free list of its size is not empty
+     */
+    template<class Integer>
+    class ResiduePool {
     public:
-        Fq(Integer p, std::size_t m){
-            Fp_b f (p);
-            std::vector<Fpelem<Integer>> v(m + 1, f.get(0));
+        static constexpr std::size_t maxFree = 1024;
 
-            v.back() = f.get(1);
-            v[0] = f.get(1);
-            while (!Fpxelem<Integer>(v).irreducible()) {
-                this->increment(v);
-                // It's divisible by the polynomial x
-                if (v[0] == 0)
-                    this->increment(v);
+        // Uninitialized memory for m residues
+        static void *allocate(std::size_t m) {
+            if (Blocks *b = blocks()) {
+                std::vector<void *> &free = b->free[m];
+                if (!free.empty()) {
+                    void *ret = free.back();
+                    free.pop_back();
+                    return ret;
+                }
             }
-            _mod = Fpxelem<Integer>(v);
+            return ::operator new(m * sizeof(Integer));
         }
 
-        Fq(Fpxelem<Integer> mod) :_mod(mod){
-            if(!mod.irreducible())
-                throw EFPXNotIrreducible("The polinomial provided to Fq was not irreducible.");
+        static void deallocate(void *p, std::size_t m) {
+            Blocks *b = blocks();
+            if (b == nullptr || b->free[m].size() >= maxFree)
+                ::operator delete(p);
+            else
+                b->free[m].push_back(p);
+        }
+
+    private:
+        struct Blocks {
+            std::map<std::size_t, std::vector<void *>> free;
+
+            ~Blocks() {
+                for (auto &size : free)
+                    for (void *p : size.second)
+                        ::operator delete(p);
+                destroyed() = true;
+            }
+        };
+
+        // Elements destroyed after the free lists of their thread (e.g. the
+        //  ones in the interned contexts) go back to the heap
+        static bool &destroyed() {
+            static thread_local bool ret = false;
+            return ret;
+        }
+
+        static Blocks *blocks() {
+            if (destroyed())
+                return nullptr;
+            static thread_local Blocks ret;
+            return &ret;
+        }
+    };
+
+    /**
+     * Coordinates of an element of F_q = F_p[x]/(f)
+     *
+     * Description:
+     *  The m residues modulo p of the element in the basis 1, x, ..., x^{m-1}.
+     *  Up to inlineDegree of them are stored inside the object, so the
+     *   elements of the usual fields (e.g. every BCH example) are never
+     *   allocated in the heap. Bigger extensions share that space with a
+     *   pointer to a block of ResiduePool.
+     */
+    template<class Integer>
+    class FqResidues {
+    public:
+        static constexpr std::size_t inlineDegree = 8;
+
+        FqResidues() { }
+
+        explicit FqResidues(std::size_t m) : _m(m) { this->construct(nullptr); }
+
+        FqResidues(const FqResidues &rhs) : _m(rhs._m) { this->construct(rhs.data()); }
+
+        FqResidues(FqResidues &&rhs) : _m(rhs._m) {
+            if (this->onHeap()) {
+                _heap = rhs._heap;
+                rhs._m = 0;
+            }
+            else
+                for (std::size_t i = 0; i < _m; ++i)
+                    new (_inline + i) Integer(std::move(rhs._inline[i]));
         }
 
+        FqResidues &operator=(const FqResidues &rhs) {
+            if (&rhs == this)
+                return *this;
+            if (_m == rhs._m)
+                std::copy(rhs.data(), rhs.data() + _m, this->data());
+            else {
+                this->destroy();
+                _m = rhs._m;
+                this->construct(rhs.data());
+            }
+            return *this;
+        }
+
+        FqResidues &operator=(FqResidues &&rhs) {
+            if (&rhs == this)
+                return *this;
+            this->destroy();
+            new (this) FqResidues(std::move(rhs));
+            return *this;
+        }
+
+        ~FqResidues() { this->destroy(); }
+
+        std::size_t size() const { return _m; }
+
+        Integer *data() { return this->onHeap() ? _heap : _inline; }
+
+        const Integer *data() const { return this->onHeap() ? _heap : _inline; }
+
+        Integer &operator[](std::size_t i) { return this->data()[i]; }
+
+        const Integer &operator[](std::size_t i) const { return this->data()[i]; }
+
+        friend bool operator==(const FqResidues &lhs, const FqResidues &rhs) {
+            return lhs._m == rhs._m && std::equal(lhs.data(), lhs.data() + lhs._m, rhs.data());
+        }
+
+        friend bool operator!=(const FqResidues &lhs, const FqResidues &rhs) { return !(lhs == rhs); }
+
+        // Whether it is the constant n
+        friend bool operator==(const FqResidues &lhs, const Integer &n) {
+            if (lhs._m == 0)
+                return n == 0;
+            for (std::size_t i = 1; i < lhs._m; ++i)
+                if (lhs[i] != 0)
+                    return false;
+            return lhs[0] == n;
+        }
+
+        friend std::string to_string(const FqResidues &a) {
+            std::string ret = "(";
+            for (std::size_t i = 0; i < a._m; ++i)
+                ret += (i ? ", " : "") + to_string(a[i]);
+            return ret + ")";
+        }
+
+        friend bool operator<(const FqResidues &lhs, const FqResidues &rhs) {
+            return std::lexicographical_compare(lhs.data(), lhs.data() + lhs._m, rhs.data(), rhs.data() + rhs._m);
+        }
+
+        friend bool operator>(const FqResidues &lhs, const FqResidues &rhs) { return rhs < lhs; }
+
+        friend bool operator<=(const FqResidues &lhs, const FqResidues &rhs) { return !(rhs < lhs); }
+
+        friend bool operator>=(const FqResidues &lhs, const FqResidues &rhs) { return !(lhs < rhs); }
+
+    private:
+        bool onHeap() const { return _m > inlineDegree; }
+
+        // Builds the _m residues as copies of src, or as zeros if it is null
+        void construct(const Integer *src) {
+            Integer *dst = _inline;
+            if (this->onHeap())
+                dst = _heap = static_cast<Integer *>(ResiduePool<Integer>::allocate(_m));
+            try {
+                if (src == nullptr)
+                    std::uninitialized_fill_n(dst, _m, Integer(0));
+                else
+                    std::uninitialized_copy_n(src, _m, dst);
+            }
+            catch (...) {
+                if (this->onHeap())
+                    ResiduePool<Integer>::deallocate(_heap, _m);
+                _m = 0;
+                throw;
+            }
+        }
+
+        void destroy() {
+            Integer *p = this->data();
+            for (std::size_t i = 0; i < _m; ++i)
+                p[i].~Integer();
+            if (this->onHeap())
+                ResiduePool<Integer>::deallocate(_heap, _m);
+            _m = 0;
+        }
+
+        std::size_t _m = 0;
+        union {
+            Integer _inline[inlineDegree];
+            Integer *_heap;
+        };
+    };
+
+    /**
+     * How the elements of F_q are stored
+     *
+     * residues: the coordinates over F_p. It works for any q.
+     * zech: the discrete logarithm with respect to a primitive element, so
+     *  products, inverses and powers are additions modulo q-1 and sums are
+     *  one lookup in the table of Zech logarithms. It needs tables with q
+     *  entries, so it is only available for q <= FqContext::zechMaxSize.
+     * normal: the coordinates in a normal basis beta, beta^p, ..., beta^{p^{m-1}},
+     *  so the Frobenius map e -> e^p is a rotation of the coordinates. When
+     *  the field is built from p and m, the modulus is chosen so that x
+     *  generates a Gaussian normal basis if there is one of type at most
+     *  FqContext::gaussianMaxType, whose products are cheaper.
+     */
+    enum class FqRepresentation { residues, zech, normal };
+
+    template<class Integer = big_int>
+    class Fq {
+    static_assert(is_integral<Integer>::value, "Type is not a supported integer.");
+    public:
+        // The modulus is looked for in diskCache before searching for it. The
+        //  hash of the file only catches corruption, and the file may come from
+        //  another build, so the one read is only taken if it is a monic
+        //  irreducible polynomial of degree m
+        Fq(Integer p, std::size_t m, FqRepresentation representation = FqRepresentation::residues){
+            const bool normal = representation == FqRepresentation::normal;
+            std::vector<std::uint32_t> key, payload;
+            diskCache::put(key, p);
+            diskCache::put(key, m);
+            diskCache::put(key, std::size_t(normal));
+            Fpxelem<Integer> mod;
+            diskCache::Entry entry;
+            if (diskCache::load("modulus", key, entry)) {
+                diskCache::Reader reader(entry);
+                if (reader.getPolynomial(mod, Fp<Integer>(p)) && reader.done() && mod.deg() == m &&
+                    mod.lc() == 1 && mod.irreducible()) {
+                    _ctx = FqContext<Integer>::intern(mod, representation, true);
+                    return;
+                }
+            }
+            mod = findModulus(p, m, normal);
+            if (diskCache::enabled()) {
+                payload.clear();
+                diskCache::putPolynomial(payload, mod);
+                diskCache::store("modulus", key, payload);
+            }
+            _ctx = FqContext<Integer>::intern(mod, representation, true);
+        }
+
+        Fq(const Fpxelem<Integer> &mod, FqRepresentation representation = FqRepresentation::residues) :
+                _ctx(FqContext<Integer>::intern(mod, representation)) { }
 
         Fq(const Fq<Integer> &f) = default;
 
         Fqelem<Integer> get(Integer n) const {
-            return Fqelem<Integer>(Fpxelem<Integer>(this->_mod.getField().get(n)), _mod);
+            FqResidues<Integer> r(_ctx->m);
+            r[0] = _ctx->base->mod.reduce(n);
+            return Fqelem<Integer>(_ctx->encode(r), _ctx);
         }
 
         Fqelem<Integer> get(const Fpxelem<Integer>& f) const {
-            return Fqelem<Integer>(f%_mod, _mod);
+            return Fqelem<Integer>(_ctx->fromPolynomial(f), _ctx);
         }
 
-        Fqelem<Integer> get(Fpxelem<Integer>&& f) const {
-            return Fqelem<Integer>(std::move(f % _mod), _mod);
-        }
+        const Fqelem<Integer> &zero() const { return _ctx->zero; }
+
+        const Fqelem<Integer> &one() const { return _ctx->one; }
+
+        Fpxelem<Integer> mod() const { return _ctx->modulus; }
+
+		Fp<Integer> getBaseField() const { return  _ctx->modulus.lc().getField(); }
 
-        Fpxelem<Integer> mod() const { return _mod; }
+        Integer getSize() const {
+            if (_ctx->size == 0)
+                throw EOperationUnsupported("The size of F" + to_string(_ctx->base->p) + "^" +
+                                            std::to_string(_ctx->m) + " does not fit in its integer type.");
+            return _ctx->size;
+        }
 
-		Fp<Integer> getBaseField() const { return  _mod.lc().getField(); }
+        Integer getP() const { return _ctx->base->p; }
 
-        Integer getSize() const { return fastPow(this->getP(), this->getM()); }
+        std::size_t getM() const { return _ctx->m; }
 
-        Integer getP() const { return _mod.lc().getSize(); }
+        FqRepresentation getRepresentation() const { return _ctx->representation; }
 
-        std::size_t getM() const { return _mod.deg(); }
+        // Nonzero entries of the multiplication table of the normal basis (0 in other representations)
+        std::size_t getNormalComplexity() const {
+            std::size_t ret = 0;
+            for (const auto &row : _ctx->normalTable)
+                ret += row.size();
+            return ret;
+        }
 
 
         std::vector<Fqelem<Integer>> getElems() const {
-            std::vector<Fqelem<Integer>> ret(static_cast<std::size_t>(this->getSize()));
-            std::vector<Fpelem<Integer>> act(this->getM(), getZero(_mod.lc()));
-            std::size_t i = 0;
+            std::vector<Fqelem<Integer>> ret;
+            ret.reserve(static_cast<std::size_t>(this->getSize()));
+            FqResidues<Integer> act(this->getM());
 
             do {
-                ret[i++] = this->get(Fpxelem<Integer>(act));
+                ret.push_back(Fqelem<Integer>(_ctx->encode(act), _ctx));
             } while (this->increment(act));
 
             return ret;
         }
 
-        bool operator==(const Fq &rhs) const { return this->_mod == rhs._mod; }
+        // Fields are interned, so two fields are equal iff they share the context
+        bool operator==(const Fq &rhs) const { return _ctx == rhs._ctx; }
 
-        bool operator!=(const Fq &rhs) const { return this->_mod != rhs._mod; }
+        bool operator!=(const Fq &rhs) const { return _ctx != rhs._ctx; }
 
         friend std::string to_string(const Fq<Integer> &e) {
             return "F" + to_string(e.getP()) + "^" + to_string(e.getM());
@@ -93,8 +359,30 @@ namespace alcp {
         }
 
     private:
+        // A Gaussian modulus for normal bases, then a sparse one and then the first irreducible
+        //  polynomial in lexicographic order
+        static Fpxelem<Integer> findModulus(const Integer &p, std::size_t m, bool normal) {
+            Fpxelem<Integer> ret;
+            if (normal && FqContext<Integer>::gaussianModulus(p, m, ret))
+                return ret;
+            if (FqContext<Integer>::sparseModulus(p, m, ret))
+                return ret;
+            Fp<Integer> f (p);
+            std::vector<Fpelem<Integer>> v(m + 1, f.get(0));
+
+            v.back() = f.get(1);
+            v[0] = f.get(1);
+            while (!Fpxelem<Integer>(v).irreducible()) {
+                increment(v);
+                // It's divisible by the polynomial x
+                if (v[0] == 0)
+                    increment(v);
+            }
+            return Fpxelem<Integer>(v);
+        }
+
         // Auxiliary functions
-        bool increment(std::vector<Fpelem<Integer>> &act) const {
+        static bool increment(std::vector<Fpelem<Integer>> &act) {
             for (auto& elem : act){
                 elem += 1;
                 if (elem != 0)
@@ -103,43 +391,1152 @@ namespace alcp {
             return false; // We are done
         }
 
+        bool increment(FqResidues<Integer> &act) const {
+            for (std::size_t i = 0; i < act.size(); ++i) {
+                act[i] = _ctx->base->mod.add(act[i], Integer(1));
+                if (act[i] != 0)
+                    return true;
+            }
+            return false; // We are done
+        }
+
         friend class Fqelem<Integer>;
 
         // The same not-so-cool trick
-        Fq(const Fpxelem<Integer>& mod, bool) : _mod(mod) { }
+        Fq(const FqContext<Integer> *ctx, bool) : _ctx(ctx) { }
 
-        Fpxelem<Integer> _mod;
+        const FqContext<Integer> *_ctx = nullptr;
     };
 
 
     template<class Integer = big_int>
-    class Fqelem : public QuotientRing<Fqelem, Fpxelem<Integer>, Integer> {
+    class Fqelem : public QuotientRing<Fqelem, FqResidues<Integer>, Integer, const FqContext<Integer> *> {
     private:
         // ::alcp::Fqelem still necessary for clang 3.9
         // http://stackoverflow.com/questions/17687459/clang-not-accepting-use-of-template-template-parameter-when-using-crtp
-        using FBase = QuotientRing<::alcp::Fqelem, Fpxelem<Integer>, Integer>;
+        using FBase = QuotientRing<::alcp::Fqelem, FqResidues<Integer>, Integer, const FqContext<Integer> *>;
 
     public:
         using F = Fq<Integer>;
         using FBase::FBase;
         using FBase::operator=;
 
-        F getField() const{ return F(this->_mod, true); }
+        Fqelem() = default;
+        Fqelem(const Fqelem & e)  = default;
+        Fqelem(Fqelem && e)  = default;
+        Fqelem & operator=(const Fqelem & e)  = default;
+        Fqelem & operator=(Fqelem && e)  = default;
+
+        F getField() const{ return F(this->mod(), true); }
+
+        // The element as a polynomial of degree < m
+        explicit operator Fpxelem<Integer>() const { return this->mod()->toPolynomial(this->_num); }
 
         friend std::string to_string(const Fqelem &e) {
-            return to_string(e._num, 't');
+            return to_string(static_cast<Fpxelem<Integer>>(e), 't');
         }
 
         friend std::string to_string_coef(const Fqelem& e){
-            if(e._num.deg() == 0)
-                return "+" + to_string(e._num.lc());
-            else if(e._num.nonZeroCoefs() == 1)
-                return "+" + to_string(e._num, 't');
-            return "+(" + to_string(e._num, 't') + ")" ;
+            const Fpxelem<Integer> pol(e);
+            if(pol.deg() == 0)
+                return "+" + to_string(pol.lc());
+            else if(pol.nonZeroCoefs() == 1)
+                return "+" + to_string(pol, 't');
+            return "+(" + to_string(pol, 't') + ")" ;
+        }
+
+        // e^{p^k}. See FqContext::frobenius
+        friend Fqelem frobenius(const Fqelem &e, std::size_t k = 1) {
+            Fqelem ret(e);
+            ret._num = e.mod()->frobenius(e._num, k);
+            return ret;
+        }
+
+        // The only r with r^p = e, i.e. e^{p^{m-1}}
+        friend Fqelem pthRoot(const Fqelem &e) { return frobenius(e, e.mod()->m - 1); }
+
+        // e + e^p + ... + e^{p^{m-1}}. See FqContext::trace
+        friend Fpelem<Integer> trace(const Fqelem &e) {
+            return e.getField().getBaseField().get(e.mod()->trace(e._num));
+        }
+
+        // e e^p ... e^{p^{m-1}}. See FqContext::norm
+        friend Fpelem<Integer> norm(const Fqelem &e) {
+            return e.getField().getBaseField().get(e.mod()->norm(e._num));
+        }
+
+        /**
+         * Minimal polynomial of e over F_p
+         *
+         * Description:
+         *  Berlekamp-Massey on the constant coefficients of 1, e, ..., e^{2m-1}.
+         *
+         * Theoretical background:
+         *  If mu is the minimal polynomial of e, every coordinate of the powers
+         *   of e satisfies the recurrence given by mu, so the minimal polynomial
+         *   of the sequence divides mu. As mu is irreducible, it is mu unless the
+         *   sequence is zero, and its first term is the constant coefficient of 1.
+         *   The sequence has linear complexity deg(mu) <= m, so 2m terms are enough.
+         *
+         * Complexity:
+         *  O(m^3): 2m products and Berlekamp-Massey on 2m terms
+         */
+        friend Fpxelem<Integer> minpoly(const Fqelem &e) {
+            const Fp<Integer> fp = e.getField().getBaseField();
+            if (e == 0)
+                return Fpxelem<Integer>(std::vector<Fpelem<Integer>>{fp.zero(), fp.one()});
+            std::vector<Fpelem<Integer>> seq;
+            Fqelem pow = getOne(e);
+            for (std::size_t k = 0; k < 2 * e.mod()->m; ++k, pow *= e)
+                seq.push_back(e.mod()->coordinates(pow._num)[0]);
+            // The connection polynomial c_0 + c_1 X + ... + c_d X^d, with c_0 = 1 and c_d != 0, is reversed
+            const Fpxelem<Integer> conn = berlekampMassey<Fpxelem<Integer>>(seq);
+            std::vector<Fpelem<Integer>> ret;
+            for (std::size_t i = conn.deg() + 1; i-- > 0;)
+                ret.push_back(conn[i]);
+            return Fpxelem<Integer>(ret);
         }
 
     private:
         friend class Fq<Integer>;
+        friend struct FqContext<Integer>;
+        friend class Fqxelem<Integer>;
+        // Polynomials over F_q store the residues of their coefficients
+        template <class>
+            friend struct CoefficientPacking;
+    };
+
+    /**
+     * Shared data of the field F_q = F_p[x]/(f)
+     *
+     * As with FpContext, there is exactly one context per modulus f and
+     *  representation. It is created (and f is checked to be irreducible)
+     *  the first time an Fq is built with f, so an Fqelem is just its
+     *  residues plus a pointer, and getField() and compatible() do not copy f.
+     *
+     * In the zech representation an element is stored as a single code c:
+     *  0 is zero and c > 0 is g^{c-1} for a primitive element g.
+     * In the normal representation it is stored as its coordinates in the
+     *  basis beta_i = beta^{p^i}, where beta is the first normal element among
+     *  x, x+1, x+2, ... (in the order of Fq::getElems).
+     *
+     * Theoretical background:
+     *  The Zech logarithm Z(n) is defined by g^{Z(n)} = 1 + g^n, so
+     *  g^i + g^j = g^i (1 + g^{j-i}) = g^{i + Z(j-i)}.
+     *  Massey-Omura: since (ab)^{p^{-k}} = a^{p^{-k}} b^{p^{-k}}, the coordinate
+     *   k of ab is c_k = sum_{i,j} lambda_ij a_{i+k} b_{j+k}, where lambda_ij is
+     *   the coordinate 0 of beta_i beta_j and the indices are taken mod m.
+     *  Gaussian normal bases: if r = tm + 1 is prime and the order k of p
+     *   mod r satisfies gcd(tm/k, m) = 1, for a primitive r-th root of unity y
+     *   and the subgroup K of order t of Z_r^*, the Gauss period
+     *   beta = sum_{s in K} y^s is a normal element of F_{p^m}, and lambda has
+     *   at most tm nonzero entries.
+     *
+     * Complexity:
+     *  Residues: O(m) sums and O(m^2) products. O(m^3 + m^2 log(p)) to build
+     *   the matrix of the Frobenius map.
+     *  Zech: O(1) for every operation. O(q m) to build the tables.
+     *  Normal: O(m) sums and Frobenius maps, O(m N) products, where N <= m^2
+     *   is the number of nonzero lambda_ij (N <= tm for a Gaussian basis).
+     *   O(m^3 + m^2 log(p)) to build the basis.
+     */
+    template<class Integer>
+    struct FqContext {
+        // Biggest field stored with Zech logarithms. Its tables take 12 bytes per element
+        static constexpr std::uint32_t zechMaxSize = 1u << 20;
+        // Random trinomials tried for every middle exponent, and pentanomials for every degree, by sparseModulus
+        static constexpr std::size_t sparseTrials = 4;
+        // Biggest type of the Gaussian normal bases looked for by Fq(p, m, normal)
+        static constexpr std::size_t gaussianMaxType = 16;
+        // Biggest degree inverted with Itoh-Tsujii instead of Euclides. Above it
+        //  the extra log(m) factor outweighs the allocations saved
+        static constexpr std::size_t itohTsujiiMaxDegree = 32;
+
+        // f as given and the context of F_p
+        Fpxelem<Integer> modulus;
+        const FpContext<Integer> *base;
+        std::size_t m;
+        // p^m, or 0 if it does not fit in an Integer
+        Integer size;
+        // x^m = sum_i reduction[i] x^i (mod f), i.e. reduction[i] = -f_i/lc(f)
+        std::vector<Integer> reduction;
+        // The i with reduction[i] != 0
+        std::vector<std::size_t> taps;
+        FqRepresentation representation;
+        // Zech tables: zech[n] is the code of 1 + g^n, exps[n] the residues of g^n packed
+        //  as an integer in base p, and codes[packed] the code of the packed residues
+        std::uint32_t order = 0;
+        std::vector<std::uint32_t> zech, exps, codes;
+        // Multiplication table of the normal basis: the pairs (j, lambda_ij) with
+        //  lambda_ij != 0 are in normalTable[i]
+        std::vector<std::vector<std::pair<std::size_t, Fpelem<Integer>>>> normalTable;
+        Fqelem<Integer> zero, one;
+
+        // Whether F_{p^m} can be stored with Zech logarithms, i.e. p^m <= zechMaxSize
+        static bool zechAvailable(const Integer &p, std::size_t m) {
+            const Integer bound = Integer(static_cast<long long>(zechMaxSize)) / p;
+            Integer q(1);
+            for (std::size_t i = 0; i < m; ++i) {
+                if (q > bound)
+                    return false;
+                q *= p;
+            }
+            return true;
+        }
+
+        static const FqContext *intern(const Fpxelem<Integer> &f,
+                                       FqRepresentation representation = FqRepresentation::residues,
+                                       bool isIrreducible = false) {
+            static std::mutex lock;
+            static std::map<std::tuple<FqRepresentation, Integer, std::vector<Integer>>,
+                            std::unique_ptr<FqContext>> registry;
+
+            std::tuple<FqRepresentation, Integer, std::vector<Integer>> key(representation, f.getSize(),
+                                                                            std::vector<Integer>());
+            for (std::size_t i = 0; i <= f.deg(); ++i)
+                std::get<2>(key).push_back(static_cast<Integer>(f[i]));
+
+            std::lock_guard<std::mutex> guard(lock);
+            auto it = registry.find(key);
+            if (it != registry.end())
+                return it->second.get();
+            if (!isIrreducible && !f.irreducible())
+                throw EFPXNotIrreducible("The polinomial provided to Fq was not irreducible.");
+            std::unique_ptr<FqContext> ctx(new FqContext(f, representation));
+            return (registry[key] = std::move(ctx)).get();
+        }
+
+        /**
+         * Sparse irreducible polynomial of degree m over F_p
+         *
+         * Description:
+         *  It looks for a binomial x^m + b, then for a trinomial x^m + a x^k + b
+         *   (k = 1, 2, ...) and then for a pentanomial, and stores the first
+         *   irreducible one in f. It returns false if there is none of them in
+         *   the candidates tried.
+         *  Binomials are only tried when they can be irreducible. The exponents
+         *   are tried in increasing order, so that the reduction needs fewer
+         *   rounds (see F2mContext), with coefficients drawn at random:
+         *   sparseTrials trinomials per exponent (all of them if p <= 3) and
+         *   sparseTrials * m pentanomials in total. The generator has a fixed
+         *   seed, so the result only depends on p and m, as the field must be
+         *   the same every time.
+         *
+         * Theoretical background:
+         *  x^m - b can only be irreducible if every prime r | m divides the order
+         *   of b, which divides p - 1, and if p = 1 (mod 4) when 4 | m.
+         *  About one in m polynomials of degree m is irreducible, and for p = 2
+         *   there are irreducible trinomials or pentanomials for every m used in
+         *   practice, so the search rarely needs many irreducibility tests.
+         *
+         * Complexity:
+         *  O(m) irreducibility tests on average
+         */
+        static bool sparseModulus(const Integer &p, std::size_t m, Fpxelem<Integer> &f) {
+            if (m == 0)
+                return false;
+            const Fp<Integer> fp(p);
+            std::mt19937_64 generator(m);
+            // A random nonzero element of F_p
+            auto coef = [&]() {
+                return p == 2 ? fp.one() : fp.get(Integer(static_cast<long long>(generator() >> 2)) % (p - 1) + 1);
+            };
+            auto irreducible = [&](const std::vector<std::pair<std::size_t, Fpelem<Integer>>> &terms) {
+                std::vector<Fpelem<Integer>> v(m + 1, fp.zero());
+                v[m] = fp.one();
+                for (const auto &t : terms)
+                    v[t.first] = t.second;
+                const Fpxelem<Integer> g(v);
+                if (!g.irreducible())
+                    return false;
+                f = g;
+                return true;
+            };
+
+            bool binomials = m == 1 || (m % 4 != 0 || (p - 1) % 4 == 0);
+            std::size_t n = m;
+            for (std::size_t r = 2; r <= n; ++r)
+                if (n % r == 0) {
+                    binomials = binomials && (p - 1) % Integer(static_cast<long long>(r)) == 0;
+                    while (n % r == 0)
+                        n /= r;
+                }
+            if (binomials)
+                for (Integer b = 1; b < p && b <= Integer(static_cast<long long>(sparseTrials * m)); b += 1)
+                    if (irreducible({{0, fp.get(b)}}))
+                        return true;
+
+            for (std::size_t k = 1; k < m; ++k) {
+                // There are (p-1)^2 <= sparseTrials trinomials for every k
+                if (p <= 3) {
+                    for (Integer a = 1; a < p; a += 1)
+                        for (Integer b = 1; b < p; b += 1)
+                            if (irreducible({{0, fp.get(b)}, {k, fp.get(a)}}))
+                                return true;
+                }
+                else
+                    for (std::size_t t = 0; t < sparseTrials; ++t)
+                        if (irreducible({{0, coef()}, {k, coef()}}))
+                            return true;
+            }
+
+            // x^m + a_3 x^{k_3} + a_2 x^{k_2} + a_1 x^{k_1} + b with k_1 < k_2 < k_3 in increasing order
+            std::size_t trials = 0;
+            for (std::size_t k3 = 3; k3 < m; ++k3)
+                for (std::size_t k2 = 2; k2 < k3; ++k2)
+                    for (std::size_t k1 = 1; k1 < k2; ++k1) {
+                        if (trials++ == sparseTrials * m)
+                            return false;
+                        if (irreducible({{0, coef()}, {k1, coef()}, {k2, coef()}, {k3, coef()}}))
+                            return true;
+                    }
+            return false;
+        }
+
+        /**
+         * Modulus of F_{p^m} whose root x is a Gauss period generating a normal basis
+         *
+         * Description:
+         *  It looks for the smallest type t <= gaussianMaxType for which there
+         *   is a Gaussian normal basis (see the background of FqContext) and
+         *   stores in f the minimal polynomial of its Gauss period. It returns
+         *   false if there is none.
+         *  The conjugates beta_i = sum_{s in K} y^{s p^i} are multiplied in
+         *   F_p[y]/(y^r - 1), where the product of the X - beta_i is constant
+         *   modulo 1 + y + ... + y^{r-1}.
+         *
+         * Complexity:
+         *  O(t^2 m^3)
+         */
+        static bool gaussianModulus(const Integer &p, std::size_t m, Fpxelem<Integer> &f) {
+            const Fp<Integer> fp(p);
+            for (std::size_t t = 1; t <= gaussianMaxType && m > 0; ++t) {
+                const std::size_t r = t * m + 1;
+                bool prime = true;
+                for (std::size_t d = 2; d * d <= r && prime; ++d)
+                    prime = r % d != 0;
+                const std::size_t pr = static_cast<std::size_t>(static_cast<long long>(p % Integer(static_cast<long long>(r))));
+                if (!prime || pr == 0)
+                    continue;
+                std::size_t k = 1;
+                for (std::size_t pk = pr; pk != 1; pk = pk * pr % r)
+                    ++k;
+                std::size_t a = t * m / k, b = m;
+                while (b != 0) {
+                    a %= b;
+                    std::swap(a, b);
+                }
+                if (a != 1)
+                    continue;
+
+                std::vector<std::size_t> subgroup;
+                for (std::size_t s = 1; s < r; ++s) {
+                    std::size_t st = 1;
+                    for (std::size_t i = 0; i < t; ++i)
+                        st = st * s % r;
+                    if (st == 1)
+                        subgroup.push_back(s);
+                }
+                // prod[d] is the coefficient of X^d, an element of F_p[y]/(y^r - 1)
+                std::vector<std::vector<Fpelem<Integer>>> prod(1, std::vector<Fpelem<Integer>>(r, fp.zero()));
+                prod[0][0] = fp.one();
+                std::size_t pi = 1;
+                for (std::size_t i = 0; i < m; ++i, pi = pi * pr % r) {
+                    prod.insert(prod.begin(), std::vector<Fpelem<Integer>>(r, fp.zero()));
+                    for (std::size_t d = 0; d + 1 < prod.size(); ++d)
+                        for (std::size_t s : subgroup) {
+                            const std::size_t e = s * pi % r;
+                            for (std::size_t l = 0; l < r; ++l)
+                                prod[d][(l + e) % r] -= prod[d + 1][l];
+                        }
+                }
+                std::vector<Fpelem<Integer>> coefs;
+                for (const auto &c : prod)
+                    coefs.push_back(c[0] - c[r - 1]);
+                f = Fpxelem<Integer>(coefs);
+                return true;
+            }
+            return false;
+        }
+
+        // Reduces the polynomial a_0 + ... + a_{n-1}x^{n-1} modulo f. a is overwritten.
+        //  Only the nonzero terms of f are used, so it is O(n w) for f of weight w.
+        //  Coefficients 1 and -1, the usual ones in sparse moduli, need no product
+        FqResidues<Integer> reduce(Integer *a, std::size_t n) const {
+            const Integer minusOne = base->p - 1;
+            for (std::size_t i = n; i-- > m;) {
+                if (a[i] == 0)
+                    continue;
+                for (std::size_t j : taps) {
+                    Integer &dst = a[i - m + j];
+                    if (reduction[j] == 1)
+                        dst = base->mod.add(dst, a[i]);
+                    else if (reduction[j] == minusOne)
+                        dst = base->mod.sub(dst, a[i]);
+                    else
+                        dst = base->mod.add(dst, base->mod.mul(a[i], reduction[j]));
+                }
+            }
+            FqResidues<Integer> ret(m);
+            std::copy(a, a + std::min(n, m), ret.data());
+            return ret;
+        }
+
+        // From the residues to the representation of the field and back
+        FqResidues<Integer> encode(const FqResidues<Integer> &a) const {
+            if (representation == FqRepresentation::zech)
+                return fromCode(codes[pack(a)]);
+            if (representation == FqRepresentation::normal)
+                return this->applyMatrix(*_toNormal, a);
+            return a;
+        }
+
+        FqResidues<Integer> decode(const FqResidues<Integer> &a) const {
+            if (representation == FqRepresentation::zech) {
+                const std::uint32_t c = toCode(a);
+                return c == 0 ? FqResidues<Integer>(m) : unpack(exps[c - 1]);
+            }
+            if (representation == FqRepresentation::normal)
+                return this->applyMatrix(*_fromNormal, a);
+            return a;
+        }
+
+        FqResidues<Integer> add(const FqResidues<Integer> &a, const FqResidues<Integer> &b) const {
+            if (representation == FqRepresentation::zech)
+                return fromCode(zechAdd(toCode(a), toCode(b)));
+            FqResidues<Integer> ret(m);
+            for (std::size_t i = 0; i < m; ++i)
+                ret[i] = base->mod.add(a[i], b[i]);
+            return ret;
+        }
+
+        FqResidues<Integer> sub(const FqResidues<Integer> &a, const FqResidues<Integer> &b) const {
+            if (representation == FqRepresentation::zech)
+                return fromCode(zechAdd(toCode(a), zechNeg(toCode(b))));
+            FqResidues<Integer> ret(m);
+            for (std::size_t i = 0; i < m; ++i)
+                ret[i] = base->mod.sub(a[i], b[i]);
+            return ret;
+        }
+
+        FqResidues<Integer> neg(const FqResidues<Integer> &a) const {
+            if (representation == FqRepresentation::zech)
+                return fromCode(zechNeg(toCode(a)));
+            FqResidues<Integer> ret(m);
+            for (std::size_t i = 0; i < m; ++i)
+                ret[i] = base->mod.neg(a[i]);
+            return ret;
+        }
+
+        FqResidues<Integer> mul(const FqResidues<Integer> &a, const FqResidues<Integer> &b) const {
+            if (representation == FqRepresentation::zech) {
+                const std::uint32_t ca = toCode(a), cb = toCode(b);
+                if (ca == 0 || cb == 0)
+                    return fromCode(0);
+                return fromCode(addLog(ca - 1, cb - 1) + 1);
+            }
+            if (representation == FqRepresentation::normal)
+                return this->mulNormal(a, b);
+            return this->mulResidues(a, b);
+        }
+
+        /**
+         * a^{-1}, for a != 0
+         *
+         * Description:
+         *  With Zech logarithms it is g^{-l} = g^{q-1-l}.
+         *  Otherwise (in any basis), up to degree itohTsujiiMaxDegree it uses the algorithm
+         *   of Itoh and Tsujii with the cached Frobenius matrices, and above
+         *   it the extended Euclidean algorithm with f.
+         *
+         * Theoretical background:
+         *  Let r = (q-1)/(p-1) = 1 + p + ... + p^{m-1}. The norm a^r is in F_p,
+         *   so a^{-1} = a^{r-1} (a^r)^{-1} needs just one inverse in F_p.
+         *  With b_k = a^{1 + p + ... + p^{k-1}}, a^{r-1} = b_{m-1}^p and
+         *   b_{2k} = b_k^{p^k} b_k, b_{k+1} = b_k^p a, so b_{m-1} is computed
+         *   following the bits of m-1 from the top.
+         *
+         * Complexity:
+         *  Zech: O(1)
+         *  Itoh-Tsujii: O(m^2 log(m)), i.e. O(log(m)) products and Frobenius maps
+         *  Euclides: O(m^2)
+         */
+        FqResidues<Integer> inv(const FqResidues<Integer> &a) const {
+            if (representation == FqRepresentation::zech) {
+                const std::uint32_t c = toCode(a);
+                return fromCode(c == 1 ? 1 : order - c + 2);
+            }
+            // For m = 1 the normal basis is {1}
+            if (m == 1) {
+                FqResidues<Integer> ret(1);
+                ret[0] = base->mod.inv(a[0]);
+                return ret;
+            }
+            if (m <= itohTsujiiMaxDegree)
+                return this->itohTsujii(a);
+            Fpxelem<Integer> x, y;
+            eea(this->toPolynomial(a), modulus, x, y);
+            return this->fromPolynomial(x);
+        }
+
+        /**
+         * a^{p^k}
+         *
+         * Description:
+         *  The Frobenius map e -> e^p is F_p-linear, so e^{p^k} is the
+         *   product of the coordinates of e by the matrix whose row i holds
+         *   the coordinates of (x^{p^k})^i. The matrix of e -> e^p is built
+         *   with the field, and the one of every other k the first time it
+         *   is needed, from the former.
+         *  With Zech logarithms it is (g^l)^{p^k} = g^{l p^k mod (q-1)}.
+         *  In a normal basis it moves the coordinate i to i+k (mod m).
+         *
+         * Complexity:
+         *  Residues: O(m^2), and O(m^3 + k m^2) the first time for each k > 1
+         *  Zech: O(k)
+         *  Normal: O(m)
+         */
+        FqResidues<Integer> frobenius(const FqResidues<Integer> &a, std::size_t k) const {
+            k %= m;
+            if (k == 0)
+                return a;
+            if (representation == FqRepresentation::zech) {
+                const std::uint32_t c = toCode(a);
+                if (c == 0)
+                    return a;
+                const std::uint64_t p = static_cast<std::uint64_t>(static_cast<long long>(base->p));
+                std::uint64_t pk = 1;
+                for (std::size_t i = 0; i < k; ++i)
+                    pk = pk * p % order;
+                return fromCode(static_cast<std::uint32_t>((c - 1) * pk % order) + 1);
+            }
+            if (representation == FqRepresentation::normal) {
+                FqResidues<Integer> ret(m);
+                for (std::size_t i = 0; i < m; ++i)
+                    ret[(i + k) % m] = a[i];
+                return ret;
+            }
+            return this->fromCoordinates(this->frobeniusMatrix(k).mulLeft(this->coordinates(a)));
+        }
+
+        // a*M, with a seen as a row vector
+        FqResidues<Integer> applyMatrix(const PreparedMatrix<Fpelem<Integer>> &mat, const FqResidues<Integer> &a) const {
+            FqResidues<Integer> ret(m);
+            mat.mulLeft([&](std::size_t j) { return Fpelem<Integer>(a[j], base); },
+                        [&ret](std::size_t i, const Fpelem<Integer> &e) { ret[i] = static_cast<Integer>(e); });
+            return ret;
+        }
+
+        /**
+         * Trace of a, i.e. a + a^p + ... + a^{p^{m-1}}
+         *
+         * Description:
+         *  The trace is F_p-linear, so it is the dot product of the coordinates
+         *   of a with the traces of x^j, which are computed with the context.
+         *   In a normal basis every Tr(beta_j) is Tr(beta).
+         *
+         * Theoretical background:
+         *  Tr(x^j) is the power sum s_j of the roots of f. With f monic,
+         *   f = x^m + c_{m-1} x^{m-1} + ... + c_0, Newton's identities give
+         *   s_0 = m and s_k = -(k c_{m-k} + sum_{i=1}^{k-1} c_{m-i} s_{k-i}).
+         *
+         * Complexity:
+         *  O(m), plus the decoding of a with Zech logarithms
+         */
+        Integer trace(const FqResidues<Integer> &a) const {
+            Accumulator<Fpelem<Integer>> acc(base->zero);
+            if (representation == FqRepresentation::normal) {
+                for (std::size_t j = 0; j < m; ++j)
+                    acc.add(Fpelem<Integer>(a[j], base));
+                return base->mod.mul(static_cast<Integer>(acc.get()), _traces[m]);
+            }
+            const FqResidues<Integer> r = this->decode(a);
+            for (std::size_t j = 0; j < m; ++j)
+                acc.addProduct(Fpelem<Integer>(r[j], base), Fpelem<Integer>(_traces[j], base));
+            return static_cast<Integer>(acc.get());
+        }
+
+        /**
+         * Norm of a, i.e. a a^p ... a^{p^{m-1}} = a^r with r = (q-1)/(p-1)
+         *
+         * Description:
+         *  With Zech logarithms it is g^{l r mod (q-1)}. Otherwise a^{r-1} is
+         *   computed as in Itoh-Tsujii (see inv), or by repeated squaring in
+         *   big extensions stored as residues whose size fits in an Integer.
+         *
+         * Complexity:
+         *  Zech: O(log(m))
+         *  Otherwise: O(m^2 log(m)), O(m^2 (m + log(p))) above itohTsujiiMaxDegree
+         */
+        Integer norm(const FqResidues<Integer> &a) const {
+            if (representation == FqRepresentation::zech) {
+                const Integer r = (size - 1) / (base->p - 1);
+                const std::uint32_t c = toCode(a);
+                if (c == 0)
+                    return Integer(0);
+                const std::uint64_t e = static_cast<std::uint64_t>(static_cast<long long>(r)) * (c - 1) % order;
+                return this->decode(fromCode(static_cast<std::uint32_t>(e) + 1))[0];
+            }
+            if (m == 1)
+                return a[0];
+            if (representation == FqRepresentation::residues && m > itohTsujiiMaxDegree && size != 0)
+                return this->powResidues(a, (size - 1) / (base->p - 1))[0];
+            return this->decode(this->mul(this->normComplement(a), a))[0];
+        }
+
+        FqResidues<Integer> fromPolynomial(const Fpxelem<Integer> &a) const {
+#ifndef ALCP_NO_CHECKS
+            if (a.lc().mod() != base)
+                throw EOperationUnsupported("The polynomial " + to_string(a) + " is not in the base field of F" +
+                                            to_string(base->p) + "^" + std::to_string(m) + ".");
+#endif
+            std::vector<Integer> aux(std::max(a.deg() + 1, m), Integer(0));
+            for (std::size_t i = 0; i <= a.deg(); ++i)
+                aux[i] = static_cast<Integer>(a[i]);
+            return this->encode(this->reduce(aux.data(), aux.size()));
+        }
+
+        Fpxelem<Integer> toPolynomial(const FqResidues<Integer> &a) const {
+            return Fpxelem<Integer>(this->coordinates(a));
+        }
+
+        std::vector<Fpelem<Integer>> coordinates(const FqResidues<Integer> &a) const {
+            const FqResidues<Integer> r = this->decode(a);
+            std::vector<Fpelem<Integer>> ret;
+            ret.reserve(m);
+            for (std::size_t i = 0; i < m; ++i)
+                ret.push_back(Fpelem<Integer>(r[i], base));
+            return ret;
+        }
+
+        FqResidues<Integer> fromCoordinates(const std::vector<Fpelem<Integer>> &v) const {
+            FqResidues<Integer> ret(m);
+            for (std::size_t i = 0; i < m; ++i)
+                ret[i] = static_cast<Integer>(v[i]);
+            return this->encode(ret);
+        }
+
+    private:
+        // _frobenius[k-1] is the matrix of e -> e^{p^k} for 0 < k < m, built once _frobeniusOnce[k-1] is set
+        std::unique_ptr<std::once_flag[]> _frobeniusOnce;
+        mutable std::vector<std::unique_ptr<PreparedMatrix<Fpelem<Integer>>>> _frobenius;
+        // Change of basis between 1, x, ..., x^{m-1} and the normal basis
+        std::unique_ptr<PreparedMatrix<Fpelem<Integer>>> _toNormal, _fromNormal;
+        // _traces[j] = Tr(x^j) for j < m, and _traces[m] = Tr(beta) in a normal basis
+        std::vector<Integer> _traces;
+
+        FqContext(const Fpxelem<Integer> &f, FqRepresentation rep) :
+                modulus(f), base(f.lc().mod()), m(f.deg()), size(powFits(base->p, m) ? fastPow(base->p, m) : Integer(0)),
+                representation(rep),
+                zero(FqResidues<Integer>(m), this), one(FqResidues<Integer>(m), this),
+                _frobeniusOnce(std::make_unique<std::once_flag[]>(m - 1)), _frobenius(m - 1) {
+            const Integer lcInv = base->mod.inv(static_cast<Integer>(f.lc()));
+            for (std::size_t i = 0; i < m; ++i) {
+                reduction.push_back(base->mod.neg(base->mod.mul(static_cast<Integer>(f[i]), lcInv)));
+                if (reduction.back() != 0)
+                    taps.push_back(i);
+            }
+            one._num[0] = Integer(1);
+            this->traces();
+            if (representation == FqRepresentation::residues && m > 1)
+                this->frobeniusMatrix(1);
+            if (representation == FqRepresentation::zech) {
+                if (!zechAvailable(base->p, m))
+                    throw EOperationUnsupported("F" + to_string(base->p) + "^" + std::to_string(m) +
+                                                " is too big to be stored with Zech logarithms.");
+                this->zechTables();
+                zero._num = this->encode(zero._num);
+                one._num = this->encode(one._num);
+            }
+            if (representation == FqRepresentation::normal) {
+                this->normalBasis();
+                one._num = this->encode(one._num);
+                FqResidues<Integer> beta(m);
+                beta[0] = Integer(1);
+                beta = this->decode(beta);
+                Accumulator<Fpelem<Integer>> acc(base->zero);
+                for (std::size_t j = 0; j < m; ++j)
+                    acc.addProduct(Fpelem<Integer>(beta[j], base), Fpelem<Integer>(_traces[j], base));
+                _traces.push_back(static_cast<Integer>(acc.get()));
+            }
+        }
+
+        // Newton's identities. See trace. reduction[i] = -c_i
+        void traces() {
+            _traces.assign(m, Integer(0));
+            _traces[0] = base->mod.reduce(Integer(static_cast<long long>(m)));
+            for (std::size_t k = 1; k < m; ++k) {
+                Accumulator<Fpelem<Integer>> acc(base->zero);
+                acc.addProduct(Fpelem<Integer>(base->mod.reduce(Integer(static_cast<long long>(k))), base),
+                               Fpelem<Integer>(reduction[m - k], base));
+                for (std::size_t i = 1; i < k; ++i)
+                    acc.addProduct(Fpelem<Integer>(reduction[m - i], base), Fpelem<Integer>(_traces[k - i], base));
+                _traces[k] = static_cast<Integer>(acc.get());
+            }
+        }
+
+        // The matrix of e -> e^p is read from diskCache if it is there (and its rows 0 and 1 are
+        //  the coordinates of 1 and x^p), and stored in it otherwise.
+        //  Row i of the matrix of e -> e^{p^k} holds the coordinates of (x^{p^k})^i, where x^{p^k}
+        //  is x after applying the former k times
+        const PreparedMatrix<Fpelem<Integer>> &frobeniusMatrix(std::size_t k) const {
+            std::call_once(_frobeniusOnce[k - 1], [this, k]() {
+                const Fpxelem<Integer> x(std::vector<Fpelem<Integer>>{base->zero, base->one});
+                Fqelem<Integer> xpk(this->fromPolynomial(x), this);
+                if (k == 1)
+                    xpk = fastPow(xpk, base->p);
+                else {
+                    std::vector<Fpelem<Integer>> v = this->coordinates(xpk._num);
+                    for (std::size_t j = 0; j < k; ++j)
+                        v = this->frobeniusMatrix(1).mulLeft(v);
+                    xpk._num = this->fromCoordinates(v);
+                }
+                std::vector<Integer> entries;
+                auto rowIs = [&](std::size_t i, const Fqelem<Integer> &e) {
+                    const std::vector<Fpelem<Integer>> c = this->coordinates(e._num);
+                    for (std::size_t l = 0; l < m; ++l)
+                        if (entries[i * m + l] != static_cast<Integer>(c[l]))
+                            return false;
+                    return true;
+                };
+                if (k != 1 || !this->loadResidues("frobenius", m * m, entries) || !rowIs(0, one) || !rowIs(1, xpk)) {
+                    entries.clear();
+                    Fqelem<Integer> pow = one;
+                    for (std::size_t i = 0; i < m; ++i, pow *= xpk)
+                        for (const auto &c : this->coordinates(pow._num))
+                            entries.push_back(static_cast<Integer>(c));
+                    if (k == 1)
+                        this->storeResidues("frobenius", entries);
+                }
+                std::vector<std::vector<Fpelem<Integer>>> rows(m);
+                for (std::size_t i = 0; i < m; ++i)
+                    for (std::size_t l = 0; l < m; ++l)
+                        rows[i].push_back(Fpelem<Integer>(entries[i * m + l], base));
+                _frobenius[k - 1] = std::make_unique<PreparedMatrix<Fpelem<Integer>>>(rows);
+            });
+            return *_frobenius[k - 1];
+        }
+
+        // Key of the entries of diskCache that depend on the field: p and f
+        std::vector<std::uint32_t> cacheKey() const {
+            std::vector<std::uint32_t> key;
+            diskCache::put(key, base->p);
+            diskCache::putPolynomial(key, modulus);
+            return key;
+        }
+
+        // n residues mod p stored under kind
+        bool loadResidues(const std::string &kind, std::size_t n, std::vector<Integer> &ret) const {
+            diskCache::Entry entry;
+            if (!diskCache::load(kind, this->cacheKey(), entry))
+                return false;
+            diskCache::Reader reader(entry);
+            ret.resize(n);
+            for (auto &r : ret)
+                if (!reader.get(r) || r >= base->p)
+                    return false;
+            return reader.done();
+        }
+
+        void storeResidues(const std::string &kind, const std::vector<Integer> &residues) const {
+            if (!diskCache::enabled())
+                return;
+            std::vector<std::uint32_t> payload;
+            for (const auto &r : residues)
+                diskCache::put(payload, r);
+            diskCache::store(kind, this->cacheKey(), payload);
+        }
+
+        // a^{r-1} = a^{p + p^2 + ... + p^{m-1}}, for m > 1 and a not stored with Zech logarithms. See inv
+        FqResidues<Integer> normComplement(const FqResidues<Integer> &a) const {
+            const std::size_t e = m - 1;
+            std::size_t bit = 8 * sizeof(std::size_t) - 1;
+            while (((e >> bit) & 1) == 0)
+                --bit;
+            FqResidues<Integer> b = a;
+            std::size_t k = 1;
+            while (bit-- > 0) {
+                b = this->mul(this->frobenius(b, k), b);
+                k *= 2;
+                if (((e >> bit) & 1) != 0) {
+                    b = this->mul(this->frobenius(b, 1), a);
+                    ++k;
+                }
+            }
+            return this->frobenius(b, 1);
+        }
+
+        // See inv. a is not zero and it is not stored with Zech logarithms
+        FqResidues<Integer> itohTsujii(const FqResidues<Integer> &a) const {
+            // The coordinates of an element of F_p are scaled by it in any basis
+            FqResidues<Integer> ret = this->normComplement(a);
+            const Integer normInv = base->mod.inv(this->decode(this->mul(ret, a))[0]);
+            for (std::size_t i = 0; i < m; ++i)
+                ret[i] = base->mod.mul(ret[i], normInv);
+            return ret;
+        }
+
+        // Schoolbook product, every coefficient being a lazy dot product, and
+        //  then reduction modulo f
+        FqResidues<Integer> mulResidues(const FqResidues<Integer> &a, const FqResidues<Integer> &b) const {
+            if (m == 0)
+                return FqResidues<Integer>();
+            Integer stack[2 * FqResidues<Integer>::inlineDegree];
+            std::vector<Integer> heap;
+            Integer *prod = stack;
+            if (m > FqResidues<Integer>::inlineDegree) {
+                heap.resize(2 * m - 1);
+                prod = heap.data();
+            }
+            for (std::size_t k = 0; k < 2 * m - 1; ++k) {
+                Accumulator<Fpelem<Integer>> acc(base->zero);
+                for (std::size_t i = k < m ? 0 : k - m + 1; i <= std::min(k, m - 1); ++i)
+                    acc.addProduct(Fpelem<Integer>(a[i], base), Fpelem<Integer>(b[k - i], base));
+                prod[k] = static_cast<Integer>(acc.get());
+            }
+            return this->reduce(prod, 2 * m - 1);
+        }
+
+        // Massey-Omura, with one lazy dot product per coordinate. The coordinates
+        //  are repeated twice, so that no index is reduced mod m
+        FqResidues<Integer> mulNormal(const FqResidues<Integer> &a, const FqResidues<Integer> &b) const {
+            std::vector<Fpelem<Integer>> aa, bb;
+            aa.reserve(2 * m);
+            bb.reserve(2 * m);
+            for (std::size_t i = 0; i < 2 * m; ++i) {
+                aa.push_back(Fpelem<Integer>(a[i < m ? i : i - m], base));
+                bb.push_back(Fpelem<Integer>(b[i < m ? i : i - m], base));
+            }
+            FqResidues<Integer> ret(m);
+            for (std::size_t k = 0; k < m; ++k) {
+                Accumulator<Fpelem<Integer>> acc(base->zero);
+                for (std::size_t i = 0; i < m; ++i) {
+                    const Fpelem<Integer> &ai = aa[i + k];
+                    if (ai == 0)
+                        continue;
+                    for (const auto &entry : normalTable[i]) {
+                        if (entry.second == 1)
+                            acc.addProduct(ai, bb[entry.first + k]);
+                        else
+                            acc.addProduct(ai, entry.second * bb[entry.first + k]);
+                    }
+                }
+                ret[k] = static_cast<Integer>(acc.get());
+            }
+            return ret;
+        }
+
+        // Gauss-Jordan elimination. It returns false if a is singular
+        bool invertMatrix(std::vector<std::vector<Integer>> a, std::vector<std::vector<Integer>> &inv) const {
+            const std::size_t n = a.size();
+            inv.assign(n, std::vector<Integer>(n, Integer(0)));
+            for (std::size_t i = 0; i < n; ++i)
+                inv[i][i] = Integer(1);
+            for (std::size_t col = 0; col < n; ++col) {
+                std::size_t piv = col;
+                while (piv < n && a[piv][col] == 0)
+                    ++piv;
+                if (piv == n)
+                    return false;
+                std::swap(a[piv], a[col]);
+                std::swap(inv[piv], inv[col]);
+                const Integer pivInv = base->mod.inv(a[col][col]);
+                for (std::size_t j = 0; j < n; ++j) {
+                    a[col][j] = base->mod.mul(a[col][j], pivInv);
+                    inv[col][j] = base->mod.mul(inv[col][j], pivInv);
+                }
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (i == col || a[i][col] == 0)
+                        continue;
+                    const Integer c = a[i][col];
+                    for (std::size_t j = 0; j < n; ++j) {
+                        a[i][j] = base->mod.sub(a[i][j], base->mod.mul(c, a[col][j]));
+                        inv[i][j] = base->mod.sub(inv[i][j], base->mod.mul(c, inv[col][j]));
+                    }
+                }
+            }
+            return true;
+        }
+
+        static PreparedMatrix<Fpelem<Integer>> toPrepared(const std::vector<std::vector<Integer>> &mat,
+                                                           const FpContext<Integer> *base) {
+            std::vector<std::vector<Fpelem<Integer>>> rows;
+            for (const auto &row : mat) {
+                rows.emplace_back();
+                for (const auto &c : row)
+                    rows.back().push_back(Fpelem<Integer>(c, base));
+            }
+            return PreparedMatrix<Fpelem<Integer>>(rows);
+        }
+
+        // beta is normal iff its conjugates are linearly independent. beta_0 beta_i
+        //  gives the row i of the table T of products by beta, and
+        //  lambda_ij = T_{j-i, -i}, since beta_i beta_j = (beta_0 beta_{j-i})^{p^i}
+        void normalBasis() {
+            FqResidues<Integer> beta(m);
+            beta[m > 1 ? 1 : 0] = Integer(1);
+            std::vector<FqResidues<Integer>> conjugates;
+            std::vector<std::vector<Integer>> rows, inverse;
+            while (true) {
+                conjugates.clear();
+                rows.clear();
+                FqResidues<Integer> act = beta;
+                for (std::size_t i = 0; i < m; ++i, act = this->powResidues(act, base->p)) {
+                    conjugates.push_back(act);
+                    rows.emplace_back(act.data(), act.data() + m);
+                }
+                if (this->invertMatrix(rows, inverse))
+                    break;
+                // The next candidate. There are normal elements, so it does not wrap around
+                for (std::size_t i = 0; i < m; ++i) {
+                    beta[i] = base->mod.add(beta[i], Integer(1));
+                    if (beta[i] != 0)
+                        break;
+                }
+            }
+            _fromNormal.reset(new PreparedMatrix<Fpelem<Integer>>(toPrepared(rows, base)));
+            _toNormal.reset(new PreparedMatrix<Fpelem<Integer>>(toPrepared(inverse, base)));
+
+            std::vector<FqResidues<Integer>> table;
+            for (std::size_t i = 0; i < m; ++i)
+                table.push_back(this->applyMatrix(*_toNormal, this->mulResidues(beta, conjugates[i])));
+            normalTable.assign(m, {});
+            for (std::size_t i = 0; i < m; ++i)
+                for (std::size_t j = 0; j < m; ++j) {
+                    const Integer &lambda = table[(j + m - i) % m][(m - i) % m];
+                    if (lambda != 0)
+                        normalTable[i].emplace_back(j, Fpelem<Integer>(lambda, base));
+                }
+        }
+
+        // Zech codes
+        static std::uint32_t toCode(const FqResidues<Integer> &a) {
+            return static_cast<std::uint32_t>(static_cast<long long>(a[0]));
+        }
+
+        static FqResidues<Integer> fromCode(std::uint32_t c) {
+            FqResidues<Integer> ret(1);
+            ret[0] = Integer(static_cast<long long>(c));
+            return ret;
+        }
+
+        // Logarithms are added modulo q-1
+        std::uint32_t addLog(std::uint32_t i, std::uint32_t j) const {
+            const std::uint32_t ret = i + j;
+            return ret >= order ? ret - order : ret;
+        }
+
+        std::uint32_t zechAdd(std::uint32_t a, std::uint32_t b) const {
+            if (a == 0)
+                return b;
+            if (b == 0)
+                return a;
+            const std::uint32_t i = a - 1, j = b - 1;
+            const std::uint32_t z = zech[j >= i ? j - i : j + order - i];
+            return z == 0 ? 0 : addLog(i, z - 1) + 1;
+        }
+
+        // -1 = g^{(q-1)/2} for odd q
+        std::uint32_t zechNeg(std::uint32_t a) const {
+            if (a == 0 || base->p == 2)
+                return a;
+            return addLog(a - 1, order / 2) + 1;
+        }
+
+        std::uint32_t pack(const FqResidues<Integer> &a) const {
+            const std::uint32_t p = static_cast<std::uint32_t>(static_cast<long long>(base->p));
+            std::uint32_t ret = 0;
+            for (std::size_t i = m; i-- > 0;)
+                ret = ret * p + static_cast<std::uint32_t>(static_cast<long long>(a[i]));
+            return ret;
+        }
+
+        FqResidues<Integer> unpack(std::uint32_t packed) const {
+            const std::uint32_t p = static_cast<std::uint32_t>(static_cast<long long>(base->p));
+            FqResidues<Integer> ret(m);
+            for (std::size_t i = 0; i < m; ++i, packed /= p)
+                ret[i] = Integer(static_cast<long long>(packed % p));
+            return ret;
+        }
+
+        template<class Exp>
+        FqResidues<Integer> powResidues(FqResidues<Integer> a, Exp n) const {
+            FqResidues<Integer> ret(m);
+            ret[0] = Integer(1);
+            for (; n != 0; n /= 2, a = this->mulResidues(a, a))
+                if (n % 2 != 0)
+                    ret = this->mulResidues(ret, a);
+            return ret;
+        }
+
+        // g is primitive iff g^{(q-1)/r} != 1 for every prime r | q-1. x is tried first
+        FqResidues<Integer> primitiveElement() const {
+            std::vector<std::uint32_t> primes;
+            std::uint32_t n = order;
+            for (std::uint32_t r = 2; r * r <= n; ++r)
+                if (n % r == 0) {
+                    primes.push_back(r);
+                    while (n % r == 0)
+                        n /= r;
+                }
+            if (n > 1)
+                primes.push_back(n);
+
+            const std::uint32_t start = m > 1 ? static_cast<std::uint32_t>(static_cast<long long>(base->p)) : 1;
+            for (std::uint32_t k = 0; k < order; ++k) {
+                const FqResidues<Integer> g = this->unpack(1 + (start - 1 + k) % order);
+                if (std::all_of(primes.begin(), primes.end(), [&](std::uint32_t r) {
+                        return this->powResidues(g, order / r) != one._num; }))
+                    return g;
+            }
+            throw EOperationUnsupported("No primitive element found. The modulus is not irreducible.");
+        }
+
+        void zechTables() {
+            const std::uint32_t q = static_cast<std::uint32_t>(static_cast<long long>(size));
+            const std::uint32_t p = static_cast<std::uint32_t>(static_cast<long long>(base->p));
+            order = q - 1;
+            exps.resize(order);
+            // The powers of g fill the tables. If g is not primitive, one of them repeats
+            auto powersOf = [&](const FqResidues<Integer> &g) {
+                codes.assign(q, 0);
+                FqResidues<Integer> act = one._num;
+                for (std::uint32_t n = 0; n < order; ++n, act = this->mulResidues(act, g)) {
+                    exps[n] = this->pack(act);
+                    if (codes[exps[n]] != 0)
+                        return false;
+                    codes[exps[n]] = n + 1;
+                }
+                return true;
+            };
+            FqResidues<Integer> g(m);
+            std::vector<Integer> cached;
+            bool filled = false;
+            if (this->loadResidues("primitive", m, cached)) {
+                std::copy(cached.begin(), cached.end(), g.data());
+                filled = powersOf(g);
+            }
+            if (!filled) {
+                g = this->primitiveElement();
+                this->storeResidues("primitive", std::vector<Integer>(g.data(), g.data() + m));
+                powersOf(g);
+            }
+            // Adding 1 only changes the lowest digit of the packed residues
+            zech.resize(order);
+            for (std::uint32_t n = 0; n < order; ++n) {
+                const std::uint32_t low = exps[n] % p;
+                zech[n] = codes[low + 1 == p ? exps[n] - low : exps[n] + 1];
+            }
+        }
+    };
+
+    // Definitions of the constants, which are odr-used when compared with an Integer
+    template<class Integer>
+    constexpr std::uint32_t FqContext<Integer>::zechMaxSize;
+
+    template<class Integer>
+    constexpr std::size_t FqContext<Integer>::sparseTrials;
+
+    template<class Integer>
+    constexpr std::size_t FqContext<Integer>::gaussianMaxType;
+
+    template<class Integer>
+    constexpr std::size_t FqContext<Integer>::itohTsujiiMaxDegree;
+
+    // Modular operations for the elements of F_q, which only store their context
+    template<class Int>
+    FqResidues<Int> addMod(const FqResidues<Int> &a, const FqResidues<Int> &b, const FqContext<Int> *ctx) {
+        return ctx->add(a, b);
+    }
+
+    template<class Int>
+    FqResidues<Int> subMod(const FqResidues<Int> &a, const FqResidues<Int> &b, const FqContext<Int> *ctx) {
+        return ctx->sub(a, b);
+    }
+
+    template<class Int>
+    FqResidues<Int> negMod(const FqResidues<Int> &a, const FqContext<Int> *ctx) { return ctx->neg(a); }
+
+    template<class Int>
+    FqResidues<Int> mulMod(const FqResidues<Int> &a, const FqResidues<Int> &b, const FqContext<Int> *ctx) {
+        return ctx->mul(a, b);
+    }
+
+    template<class Int>
+    FqResidues<Int> invMod(const FqResidues<Int> &a, const FqContext<Int> *ctx) { return ctx->inv(a); }
+
+    /**
+     * Multiplication by a fixed element of F_q
+     *
+     * Description:
+     *  Multiplying by w is an F_p-linear map of F_q = F_p[x]/(f). Its matrix
+     *   in the basis 1, x, ..., x^{m-1} (row j holds the coordinates of
+     *   w*x^j) is prepared once, so every product is an m x m matrix-vector
+     *   product over F_p with Shoup's multiplication, with no polynomial
+     *   division. The product is written straight into the residues of the
+     *   result, so there are no allocations apart from the result.
+     *  In the normal representation the matrix is taken in the normal basis,
+     *   so the stored coordinates are multiplied directly. With Zech
+     *   logarithms a product is already O(1), so there is no matrix.
+     *  The copies share the matrix.
+     *
+     * Complexity:
+     *  O(m^2) to build and O(m^2) per product, O(1) with Zech logarithms
+     */
+    template<class Integer>
+    class PreparedMultiplier<Fqelem<Integer>, void> {
+    public:
+        explicit PreparedMultiplier(const Fqelem<Integer> &w) : _w(w) {
+            if (w.mod()->representation != FqRepresentation::zech)
+                _byW = std::make_shared<const PreparedMatrix<Fpelem<Integer>>>(mulMatrix(w));
+        }
+
+        Fqelem<Integer> mul(const Fqelem<Integer> &a) const {
+            const FqContext<Integer> *ctx = _w.mod();
+            // A product is already O(1)
+            if (ctx->representation == FqRepresentation::zech)
+                return _w * a;
+            // The residues and the normal coordinates are already the vector
+            //  that the matrix acts on
+            Fqelem<Integer> ret(_w);
+            ret._num = ctx->applyMatrix(*_byW, a._num);
+            return ret;
+        }
+
+        const Fqelem<Integer> &get() const { return _w; }
+
+    private:
+        static std::vector<std::vector<Fpelem<Integer>>> mulMatrix(const Fqelem<Integer> &w) {
+            const FqContext<Integer> *ctx = w.mod();
+            Fq<Integer> field = w.getField();
+            Fp<Integer> baseField = field.getBaseField();
+            const Fqelem<Integer> x = field.get(
+                    Fpxelem<Integer>(std::vector<Fpelem<Integer>>{baseField.zero(), baseField.one()}));
+            std::vector<std::vector<Fpelem<Integer>>> ret;
+            ret.reserve(ctx->m);
+            if (ctx->representation == FqRepresentation::normal) {
+                // Row j holds the coordinates of w*beta_j
+                for (std::size_t j = 0; j < ctx->m; ++j) {
+                    FqResidues<Integer> betaj(ctx->m);
+                    betaj[j] = Integer(1);
+                    const FqResidues<Integer> prod = ctx->mul(w._num, betaj);
+                    ret.emplace_back();
+                    for (std::size_t i = 0; i < ctx->m; ++i)
+                        ret.back().push_back(baseField.get(prod[i]));
+                }
+                return ret;
+            }
+            Fqelem<Integer> wxj = w;
+            for (std::size_t j = 0; j < ctx->m; ++j) {
+                ret.push_back(ctx->coordinates(wxj._num));
+                wxj *= x;
+            }
+            return ret;
+        }
+
+        Fqelem<Integer> _w;
+        // Empty with Zech logarithms
+        std::shared_ptr<const PreparedMatrix<Fpelem<Integer>>> _byW;
     };
 
     using Fqelem_b = Fqelem<big_int>;
@@ -2,12 +2,65 @@
 #ifndef __FQXELEM_HPP
 #define __FQXELEM_HPP
 
+#include <algorithm>    // std::copy, std::min
 #include <vector>
 
 #include "fqelem.hpp"
 #include "polRing.hpp"
+#include "packedCoefficients.hpp"
 
 namespace alcp {
+    template<class Integer>
+    class Fqxelem;
+
+    // An element of F_q is stored as its code with Zech logarithms and as
+    //  its m coordinates otherwise
+    template<class Integer>
+    struct CoefficientPacking<Fqelem<Integer>> {
+        using Word = Integer;
+        using Context = FqContext<Integer>;
+
+        static std::size_t width(const Context *ctx) {
+            return ctx == nullptr || ctx->representation == FqRepresentation::zech ? 1 : ctx->m;
+        }
+
+        static const Context *context(const Fqelem<Integer> &e) { return e.mod(); }
+
+        static const Fqelem<Integer> &zero(const Context *ctx) { return ctx->zero; }
+
+        static Fqelem<Integer> read(const Context *ctx, const Integer *w) {
+            Fqelem<Integer> ret(ctx->zero);
+            std::copy(w, w + width(ctx), ret._num.data());
+            return ret;
+        }
+
+        static void write(Integer *w, const Fqelem<Integer> &e) {
+            std::copy(e._num.data(), e._num.data() + e._num.size(), w);
+        }
+    };
+
+    // Polynomials over F_q keep the coefficients in one buffer of m n words
+    template<class Integer>
+    struct CoefficientStorage<Fqelem<Integer>> {
+        using type = PackedCoefficients<Fqelem<Integer>>;
+    };
+
+    // Karatsuba is only used below kroneckerThreshold and with Zech
+    //  logarithms, so it is measured with the latter: q = 2^8 and q = 251^2
+    //  give between 10 and 16
+    template<>
+    struct KaratsubaThreshold<Fqxelem> {
+        static constexpr std::size_t value = 10;
+    };
+
+    // Without Zech logarithms the products of Fqxelem are Kronecker
+    //  substitutions, far cheaper than its long division. Measured with
+    //  q = 2^8 and q = 1000003^4, where the crossover is between 128 and 256
+    template<>
+    struct NewtonDivisionThreshold<Fqxelem> {
+        static constexpr std::size_t value = 256;
+    };
+
     template<class Integer>
     class Fqxelem : public PolynomialRing<Fqxelem, Fqelem<Integer>, Integer> {
     private:
@@ -19,6 +72,13 @@ namespace alcp {
         using F = Fq<Integer>;
         using Felem = Fqelem<Integer>;
 
+        // Products where both factors have at least this number of coefficients
+        //  are computed in F_p[t][x], packing every factor in one Fpxelem, unless
+        //  the field is stored with Zech logarithms, whose products are cheaper
+        static constexpr std::size_t kroneckerThreshold = 8;
+        // NewtonDivisionThreshold with Zech logarithms
+        static constexpr std::size_t zechNewtonThreshold = 2048;
+
         // Inherit ctor
         using FBase::FBase;
 
@@ -61,6 +121,74 @@ namespace alcp {
 			   return ret;
 		   }()){}
 
+        using FBase::operator*=;
+
+        /**
+         * Product with Kronecker substitution
+         *
+         * Description:
+         *  Every coefficient of a factor is a polynomial of degree < m in
+         *   F_p[t], so the factor is a polynomial in F_p[t][x]. Substituting
+         *   x = t^{2m-1} packs it in one Fpxelem, the coefficient i taking the
+         *   block of 2m-1 coefficients starting at i(2m-1). The packed factors
+         *   are multiplied with the product of Fpxelem, i.e. with the NTT when
+         *   they are long enough, and every block of the product is reduced
+         *   modulo f once.
+         *  Elements stored in a normal basis are decoded to residues and the
+         *   product is encoded back.
+         *
+         * Theoretical background:
+         *  The product of two coefficients has degree at most 2m - 2 in t, so
+         *   the blocks of the product do not overlap.
+         *
+         * Complexity:
+         *  One product in F_p[X] of n(2m-1) by k(2m-1) coefficients and n + k - 1
+         *   reductions modulo f, instead of the n k (or O(n^{log2(3)}) with
+         *   Karatsuba) products and reductions in F_q
+         */
+        Fqxelem &operator*=(const Fqxelem &rhs) {
+            const std::size_t n = this->_v.size(), k = rhs._v.size();
+            if (std::min(n, k) < kroneckerThreshold || this->lc().mod()->representation == FqRepresentation::zech)
+                return FBase::operator*=(rhs);
+#ifndef ALCP_NO_CHECKS
+            if (!compatible(*this, rhs))
+                throw EOperationUnsupported("Polynomials not in the same ring. Error when multiplying the "
+                                            "polynomials.\nThe values that caused it were " + to_string(*this) +
+                                            " and " + to_string(rhs) + ".");
+#endif
+            const FqContext<Integer> *ctx = this->lc().mod();
+            const std::size_t m = ctx->m, stride = 2 * m - 1;
+            // A square multiplies the packed polynomial by itself, so that
+            //  Fpxelem sees it and transforms it just once
+            Fpxelem<Integer> prod = this->pack();
+            if (this == &rhs)
+                prod *= prod;
+            else
+                prod *= rhs.pack();
+
+            // The coefficients of the product are written in place, m words each
+            typename FBase::Storage ret(n + k - 1, ctx->zero);
+            Integer *out = ret.data();
+            std::vector<Integer> block(stride);
+            for (std::size_t i = 0; i < n + k - 1; ++i) {
+                for (std::size_t j = 0; j < stride; ++j)
+                    block[j] = i * stride + j <= prod.deg() ? static_cast<Integer>(prod[i * stride + j]) : Integer(0);
+                const FqResidues<Integer> r = ctx->encode(ctx->reduce(block.data(), stride));
+                std::copy(r.data(), r.data() + m, out + i * m);
+            }
+            this->_v = std::move(ret);
+            this->removeTrailingZeros();
+            return *this;
+        }
+
+        using FBase::div2;
+
+        std::pair<Fqxelem, Fqxelem> div2(const Fqxelem &divisor) const {
+            if (this->lc().mod()->representation == FqRepresentation::zech)
+                return FBase::div2(*this, divisor, zechNewtonThreshold);
+            return FBase::div2(*this, divisor, NewtonDivisionThreshold<::alcp::Fqxelem>::value);
+        }
+
         const Fq<Integer> getField() const {
             return this->lc().getField();
         }
@@ -88,6 +216,28 @@ namespace alcp {
         friend bool operator!=(const Fqxelem<Integer> &lhs, Integer rhs) { return !(lhs == rhs); }
 
         friend bool operator!=(Integer lhs, const Fqxelem<Integer> &rhs) { return !(rhs == lhs); }
+
+    private:
+        // The coefficients in F_p[t] at x = t^{2m-1}
+        Fpxelem<Integer> pack() const {
+            const FqContext<Integer> *ctx = this->lc().mod();
+            const Fp<Integer> fp = this->getField().getBaseField();
+            const std::size_t m = ctx->m, stride = 2 * m - 1;
+            const std::size_t n = this->_v.size();
+            std::vector<Fpelem<Integer>> ret((n - 1) * stride + m, fp.zero());
+            // The residues are read from the buffer of the coefficients, m words each
+            const Integer *words = this->_v.data();
+            FqResidues<Integer> r(m);
+            for (std::size_t i = 0; i < n; ++i) {
+                std::copy(words + i * m, words + (i + 1) * m, r.data());
+                if (ctx->representation == FqRepresentation::normal)
+                    r = ctx->decode(r);
+                for (std::size_t j = 0; j < m; ++j)
+                    if (r[j] != 0)
+                        ret[i * stride + j] = fp.get(r[j]);
+            }
+            return Fpxelem<Integer>(ret);
+        }
     };
 
     using Fqxelem_b = Fqxelem<big_int>;
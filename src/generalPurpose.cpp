@@ -3,6 +3,8 @@
 #include <map>
 #include <cmath>
 
+#include "modArith.hpp"
+
 namespace alcp {
 
 /**
@@ -30,6 +32,8 @@ namespace alcp {
  *  Even though here we implement the classical version of the algorithm, if we
  *   restrict ourselves to long long integers, it is enough to check with:
  *  a = 2,3,4,5,11,13,17,19,23,29,31 and 37
+ *  The products are reduced through Modulus, so they do not overflow for any
+ *   n representable as a big_int
  */
     bool millerRabin(big_int n, int k /*= 35*/) {
         big_int s = n - 1, a;
@@ -45,17 +49,18 @@ namespace alcp {
             s /= 2;
             r++;
         }
+        Modulus<big_int> mod(n);
         while (k--) {
             // Generate a random number a<-{2..n-2}
             a = (rand() % (n - 3)) + 2;
-            a = fastPowMod(a, s, n);
+            a = powMod(a, s, mod);
 
             // if a=1,n-1, we are not going to find any non trivial root
             // since a^2 (mod n) = 1
             if (a == 1 || a == n - 1) continue;
 
             for (int i = 0; i < r; i++) {
-                a = (a * a) % n;
+                a = mod.mul(a, a);
 
                 // If we find a non trivial root of the unity
                 if (a == 1) return false;
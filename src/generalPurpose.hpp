@@ -1,7 +1,11 @@
 #ifndef __GENERAL_PURPOSE_H
 #define __GENERAL_PURPOSE_H
 
+#include <cstddef>      // std::size_t
+#include <limits>       // std::numeric_limits
 #include <map>
+#include <vector>
+#include <iterator>     // std::iterator_traits, std::begin, std::end
 
 
 #include "types.hpp"
@@ -139,6 +143,62 @@ namespace alcp {
         return result;
     }
 
+    // Whether b^e, for b > 1, is representable as a T. The types without a
+    //  bound in std::numeric_limits, like the boost numbers, hold every power
+    template<typename T>
+    bool powFits(const T &b, std::size_t e) {
+        if (!std::numeric_limits<T>::is_bounded)
+            return true;
+        const T bound = std::numeric_limits<T>::max() / b;
+        T result = getOne(b);
+        for (; e != 0; --e) {
+            if (result > bound)
+                return false;
+            result *= b;
+        }
+        return true;
+    }
+
+    /**
+     * Batch inversion (Montgomery's trick)
+     *
+     * Description:
+     *  Replaces every element of [first, last) by its multiplicative inverse.
+     *  It throws the same exception as inv() if one of them is not invertible.
+     *
+     * Theoretical background:
+     *  Let c_i = a_0 * ... * a_i. Then a_i^{-1} = c_{i-1} * c_i^{-1} and
+     *   c_{i-1}^{-1} = a_i * c_i^{-1}, so after computing the prefix products
+     *   every inverse can be obtained from c_{n-1}^{-1} going backwards.
+     *
+     * Complexity:
+     *  One inversion and 3(n-1) multiplications
+     */
+    template<typename BidirIt>
+    void batchInvert(BidirIt first, BidirIt last) {
+        using T = typename std::iterator_traits<BidirIt>::value_type;
+        if (first == last)
+            return;
+        std::vector<T> prefix;
+        prefix.push_back(*first);
+        for (BidirIt it = std::next(first); it != last; ++it)
+            prefix.push_back(prefix.back() * *it);
+
+        T inv = prefix.back().inv();
+        for (std::size_t i = prefix.size() - 1; i > 0; --i) {
+            --last;
+            T aux = inv * prefix[i - 1];
+            inv *= *last;
+            *last = std::move(aux);
+        }
+        *first = std::move(inv);
+    }
+
+    template<typename Range>
+    void batchInvert(Range &r) {
+        batchInvert(std::begin(r), std::end(r));
+    }
+
     bool millerRabin(big_int n, int k = 35);
 
     long long pollardRhoBrent(long long n, long long limit = 1000);
@@ -58,8 +58,10 @@ namespace alcp {
 		big_int leadCoef = polynomial.lc();
 		Zxelem_b pol = polynomial * leadCoef;
 		Fpxelem_b::Felem lc = u1.getField().get(leadCoef);
-		u1 *= (lc * u1.lc().inv()); //This is more efficient than normalize and then multiply by lc
-		w1 *= (lc * w1.lc().inv());
+		std::vector<Fpxelem_b::Felem> lcInv{u1.lc(), w1.lc()};
+		batchInvert(lcInv);
+		u1 *= (lc * lcInv[0]); //This is more efficient than normalize and then multiply by lc
+		w1 *= (lc * lcInv[1]);
 
 		Fpxelem_b s, t;
 		eea<Fpxelem_b>(u1, w1, s, t); //This must always be 1. Test it!!
@@ -70,7 +70,7 @@ namespace alcp {
             }
         } //Now in aux[which] are the multiplicities of the possible sums
         if (verbose) {
-            std::cout << "Posibles sumas para el primo " << factors[0].first.getSize() << std::endl;
+            std::cout << "Posibles sumas para el primo " << to_string(factors[0].first.getSize()) << std::endl;
             for (std::size_t i = 1; i <= semiSumOfDeg; i++) {
                 if (aux[which][i] != 0) {
                     std::cout << i << " ";
@@ -133,7 +133,7 @@ namespace alcp {
             globind = std::move(global[index]);
             global.clear();
             if (verbose) {
-                std::cout << "El primo que he escogido es " << globind.pol.getSize() << " y hay " << min <<
+                std::cout << "El primo que he escogido es " << to_string(globind.pol.getSize()) << " y hay " << min <<
                 " posibilidades" << std::endl;
                 std::cout << "Esta es la factorizacion modulo el primo:";
                 for (auto aaa: globind.factors)
@@ -0,0 +1,32 @@
+#include "hybridInt.hpp"
+
+#include <limits>
+#include <ostream>
+#include <string>
+
+#include "exceptions.hpp"
+
+namespace alcp {
+    HybridInt::HybridInt(const Big &n) {
+        if (n >= std::numeric_limits<long long>::min() && n <= std::numeric_limits<long long>::max())
+            _small = n.convert_to<long long>();
+        else
+            _big.reset(new Big(n));
+    }
+
+    HybridInt::operator long long() const {
+#ifndef ALCP_NO_CHECKS
+        if (!this->isSmall())
+            throw EOperationUnsupported("The integer " + to_string(*this) + " does not fit in a long long.");
+#endif
+        return _small;
+    }
+
+    std::string to_string(const HybridInt &n) {
+        return n.isSmall() ? std::to_string(n._small) : n._big->convert_to<std::string>();
+    }
+
+    std::ostream &operator<<(std::ostream &os, const HybridInt &n) {
+        return os << to_string(n);
+    }
+}
@@ -0,0 +1,163 @@
+#ifndef __HYBRID_INT_HPP
+#define __HYBRID_INT_HPP
+
+#include <iosfwd>
+#include <limits>       // std::numeric_limits
+#include <memory>       // std::unique_ptr
+#include <string>
+#include <type_traits>  // std::true_type
+
+#include "types.hpp"
+#include "kronecker.hpp"
+
+namespace alcp {
+    /**
+     * Integer with a small and a big representation
+     *
+     * Description:
+     *  Arbitrary precision integer that stores its value inline as a long long
+     *   and moves it to the heap, as a boost cpp_int, only when the result of
+     *   an operation does not fit in 64 bits. Whenever a result fits again it
+     *   goes back to the inline representation, so the representation of a
+     *   value is unique.
+     *  It can be used as the Integer of Zxelem, integerCRA and modularGCD,
+     *   where the coefficients are small most of the time but the bounds and
+     *   the moduli of the lifting steps may overflow a long long.
+     *
+     * Theoretical background:
+     *  Overflow is detected with the checked arithmetic builtins of the
+     *   compiler, so the fast path costs one extra branch per operation.
+     *  Division truncates towards zero, as the built-in types do.
+     *
+     * Complexity:
+     *  O(1) per operation when the operands and the result fit in 64 bits.
+     *  The cost of cpp_int otherwise
+     */
+    class HybridInt {
+    public:
+        using Big = bmp::cpp_int;
+
+        HybridInt() = default;
+
+        HybridInt(long long n) : _small(n) { }
+
+        explicit HybridInt(const Big &n);
+
+        HybridInt(const HybridInt &n) : _small(n._small), _big(n._big ? new Big(*n._big) : nullptr) { }
+
+        HybridInt(HybridInt &&n) = default;
+
+        HybridInt &operator=(const HybridInt &n) {
+            if (this != &n)
+                *this = HybridInt(n);
+            return *this;
+        }
+
+        HybridInt &operator=(HybridInt &&n) = default;
+
+        // Whether the value is stored inline
+        bool isSmall() const { return !_big; }
+
+        Big toBig() const { return _big ? *_big : Big(_small); }
+
+        // Throws EOperationUnsupported if the value does not fit
+        explicit operator long long() const;
+
+        friend HybridInt operator+(const HybridInt &lhs, const HybridInt &rhs) {
+            long long r;
+            if (lhs.isSmall() && rhs.isSmall() && !__builtin_add_overflow(lhs._small, rhs._small, &r))
+                return r;
+            return HybridInt(lhs.toBig() + rhs.toBig());
+        }
+
+        friend HybridInt operator-(const HybridInt &lhs, const HybridInt &rhs) {
+            long long r;
+            if (lhs.isSmall() && rhs.isSmall() && !__builtin_sub_overflow(lhs._small, rhs._small, &r))
+                return r;
+            return HybridInt(lhs.toBig() - rhs.toBig());
+        }
+
+        friend HybridInt operator*(const HybridInt &lhs, const HybridInt &rhs) {
+            long long r;
+            if (lhs.isSmall() && rhs.isSmall() && !__builtin_mul_overflow(lhs._small, rhs._small, &r))
+                return r;
+            return HybridInt(lhs.toBig() * rhs.toBig());
+        }
+
+        friend HybridInt operator/(const HybridInt &lhs, const HybridInt &rhs) {
+            // LLONG_MIN / -1 is the only quotient of two long long that overflows
+            if (lhs.isSmall() && rhs.isSmall() && rhs._small != -1)
+                return lhs._small / rhs._small;
+            return HybridInt(lhs.toBig() / rhs.toBig());
+        }
+
+        friend HybridInt operator%(const HybridInt &lhs, const HybridInt &rhs) {
+            if (lhs.isSmall() && rhs.isSmall())
+                return rhs._small == -1 ? 0 : lhs._small % rhs._small;
+            return HybridInt(lhs.toBig() % rhs.toBig());
+        }
+
+        HybridInt operator-() const {
+            if (this->isSmall() && _small != std::numeric_limits<long long>::min())
+                return -_small;
+            return HybridInt(-this->toBig());
+        }
+
+        HybridInt &operator+=(const HybridInt &rhs) { return *this = *this + rhs; }
+
+        HybridInt &operator-=(const HybridInt &rhs) { return *this = *this - rhs; }
+
+        HybridInt &operator*=(const HybridInt &rhs) { return *this = *this * rhs; }
+
+        HybridInt &operator/=(const HybridInt &rhs) { return *this = *this / rhs; }
+
+        HybridInt &operator%=(const HybridInt &rhs) { return *this = *this % rhs; }
+
+        friend bool operator==(const HybridInt &lhs, const HybridInt &rhs) {
+            // The representation is unique, so a small value is never equal to a big one
+            if (lhs.isSmall() || rhs.isSmall())
+                return lhs.isSmall() && rhs.isSmall() && lhs._small == rhs._small;
+            return *lhs._big == *rhs._big;
+        }
+
+        friend bool operator!=(const HybridInt &lhs, const HybridInt &rhs) { return !(lhs == rhs); }
+
+        friend bool operator<(const HybridInt &lhs, const HybridInt &rhs) {
+            if (lhs.isSmall() && rhs.isSmall())
+                return lhs._small < rhs._small;
+            return lhs.toBig() < rhs.toBig();
+        }
+
+        friend bool operator>(const HybridInt &lhs, const HybridInt &rhs) { return rhs < lhs; }
+
+        friend bool operator<=(const HybridInt &lhs, const HybridInt &rhs) { return !(rhs < lhs); }
+
+        friend bool operator>=(const HybridInt &lhs, const HybridInt &rhs) { return !(lhs < rhs); }
+
+        friend std::string to_string(const HybridInt &n);
+
+        friend std::ostream &operator<<(std::ostream &os, const HybridInt &n);
+
+    private:
+        long long _small = 0;
+        // Not null iff the value does not fit in a long long
+        std::unique_ptr<Big> _big;
+    };
+
+    template<>
+    struct is_integral<HybridInt> : std::true_type { };
+
+    // The products of coefficients that fit in a long long are not packed
+    template<>
+    struct KroneckerPacking<HybridInt> {
+        using Wide = HybridInt::Big;
+
+        static constexpr std::size_t minBits = 63;
+
+        static Wide widen(const HybridInt &n) { return n.toBig(); }
+
+        static HybridInt narrow(const Wide &n) { return HybridInt(n); }
+    };
+}
+
+#endif // __HYBRID_INT_HPP
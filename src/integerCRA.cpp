@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "types.hpp"
+#include "hybridInt.hpp"
 #include "zelem.hpp"
 #include "generalPurpose.hpp"
 #include "exceptions.hpp"
@@ -11,8 +12,9 @@ namespace alcp {
     /* Auxiliary function. Finds x such that
      * ax = 1 (mod q)
      * */
-	big_int reciprocal(big_int a, big_int q) {
-		big_int x, y;
+	template<class Integer>
+	Integer reciprocal(const Integer &a, const Integer &q) {
+		Integer x, y;
 		eea(a, q, x, y);
 		return x;
 	}
@@ -40,10 +42,11 @@ namespace alcp {
      *  O(n^2)
      *
      */
-	big_int integerCRA(const std::vector<big_int> &m, const std::vector<big_int> &u) {
+	template<class Integer>
+	Integer integerCRA(const std::vector<Integer> &m, const std::vector<Integer> &u) {
 		const int n = static_cast<int>(m.size() - 1);
-		big_int prod, aux;
-		std::vector<big_int> inv(n), v(n + 1);
+		Integer prod, aux;
+		std::vector<Integer> inv(n), v(n + 1);
 		if (m.size() != u.size())
 			throw EDifferentSizeVectorsCRA("The vectors in integerCRA have to be of the same size.");
 		for (int k = 1; k <= n; ++k) {
@@ -65,10 +68,14 @@ namespace alcp {
 				v[k] += m[k];
 		}
 		// Compute the result using horner's algorithm
-		big_int result = v[n];
+		Integer result = v[n];
 		for (int k = n - 1; k >= 0; --k) {//This must be int because size_t is always >=0 so the loop would be infinite
 			result = result * m[k] + v[k];
 		}
 		return result;
 	}
+
+	template big_int integerCRA(const std::vector<big_int> &m, const std::vector<big_int> &u);
+
+	template HybridInt integerCRA(const std::vector<HybridInt> &m, const std::vector<HybridInt> &u);
 }
@@ -6,7 +6,9 @@
 #include <vector>
 
 namespace alcp {
-    big_int integerCRA(const std::vector<big_int> &m, const std::vector<big_int> &u);
+    // Integer is big_int when the vectors are given as braced lists
+    template<class Integer = big_int>
+    Integer integerCRA(const std::vector<Integer> &m, const std::vector<Integer> &u);
 }
 
 
@@ -0,0 +1,103 @@
+#ifndef __KARATSUBA_HPP
+#define __KARATSUBA_HPP
+
+#include <algorithm>    // std::min, std::max, std::swap
+#include <cstddef>      // std::size_t
+
+#include "accumulator.hpp"
+
+namespace alcp {
+    /**
+     * Products of arrays of coefficients over any ring
+     *
+     * Description:
+     *  mul computes r = a*b, where a has n coefficients and b has m. When the
+     *   shortest factor has fewer than threshold coefficients it is the
+     *   schoolbook product, with one Accumulator per coefficient of r.
+     *   Otherwise it splits the factors in halves and recurses.
+     *  Every intermediate result is stored in one scratch buffer of
+     *   scratchSize(n, m, threshold) elements, so the recursion does not
+     *   allocate.
+     *  If b has at most half the coefficients of a, a is split in halves and
+     *   each of them is multiplied by b.
+     *
+     * Theoretical background:
+     *  Karatsuba: with X = x^k, (a0 + a1 X)(b0 + b1 X) =
+     *   a0 b0 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) X + a1 b1 X^2
+     *
+     * Complexity:
+     *  O(n^{log2(3)}) products of coefficients for n = m
+     *  O(m^{log2(3)-1} n) products for n >= m
+     */
+    namespace karatsuba {
+        // Threshold of the schoolbook product for every size
+        constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+        // r[0..n+m-1) = a[0..n) * b[0..m). a and b are anything indexable
+        template<class Felem, class A, class B>
+        void schoolbook(Felem *r, const A &a, std::size_t n, const B &b, std::size_t m, const Felem &zero) {
+            for (std::size_t k = 0; k < n + m - 1; ++k) {
+                Accumulator<Felem> acc(zero);
+                const std::size_t last = std::min(k, n - 1);
+                for (std::size_t i = k < m ? 0 : k - m + 1; i <= last; ++i)
+                    acc.addProduct(a[i], b[k - i]);
+                r[k] = acc.get();
+            }
+        }
+
+        inline std::size_t scratchSize(std::size_t n, std::size_t m, std::size_t threshold) {
+            if (n < m)
+                std::swap(n, m);
+            if (m < std::max<std::size_t>(threshold, 2))
+                return 0;
+            const std::size_t k = (n + 1) / 2;
+            if (m <= k)
+                return n - k + m - 1 + std::max(scratchSize(k, m, threshold), scratchSize(n - k, m, threshold));
+            return 4 * k - 1 + scratchSize(k, k, threshold);
+        }
+
+        // r[0..n+m-1) = a[0..n) * b[0..m). r must not overlap a, b or scratch
+        template<class Felem>
+        void mul(Felem *r, const Felem *a, std::size_t n, const Felem *b, std::size_t m,
+                 Felem *scratch, std::size_t threshold, const Felem &zero) {
+            if (n < m) {
+                std::swap(a, b);
+                std::swap(n, m);
+            }
+            if (m < std::max<std::size_t>(threshold, 2)) {
+                schoolbook(r, a, n, b, m, zero);
+                return;
+            }
+            const std::size_t k = (n + 1) / 2;
+            if (m <= k) {
+                // a0 b + a1 b X, with a1 b computed in the scratch
+                const std::size_t len = n - k + m - 1;
+                mul(r, a, k, b, m, scratch + len, threshold, zero);
+                std::fill(r + k + m - 1, r + n + m - 1, zero);
+                mul(scratch, a + k, n - k, b, m, scratch + len, threshold, zero);
+                for (std::size_t i = 0; i < len; ++i)
+                    r[k + i] += scratch[i];
+                return;
+            }
+            // z0 = a0 b0 and z2 = a1 b1 go straight to r, and the scratch holds
+            //  a0 + a1, b0 + b1 and z1 = (a0 + a1)(b0 + b1)
+            mul(r, a, k, b, k, scratch, threshold, zero);
+            r[2 * k - 1] = zero;
+            mul(r + 2 * k, a + k, n - k, b + k, m - k, scratch, threshold, zero);
+            Felem *sa = scratch, *sb = scratch + k, *z1 = scratch + 2 * k;
+            for (std::size_t i = 0; i < k; ++i) {
+                sa[i] = i < n - k ? a[i] + a[k + i] : a[i];
+                sb[i] = i < m - k ? b[i] + b[k + i] : b[i];
+            }
+            mul(z1, sa, k, sb, k, scratch + 4 * k - 1, threshold, zero);
+            for (std::size_t i = 0; i < 2 * k - 1; ++i)
+                z1[i] -= r[i];
+            for (std::size_t i = 0; i < n + m - 2 * k - 1; ++i)
+                z1[i] -= r[2 * k + i];
+            for (std::size_t i = 0; i < 2 * k - 1; ++i)
+                r[k + i] += z1[i];
+        }
+    }
+}
+
+#endif // __KARATSUBA_HPP
@@ -0,0 +1,255 @@
+#ifndef __KRONECKER_HPP
+#define __KRONECKER_HPP
+
+#include <algorithm>    // std::min, std::max, std::fill
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <iterator>     // std::back_inserter
+#include <type_traits>  // std::enable_if_t
+#include <vector>
+
+#include "types.hpp"
+
+namespace alcp {
+    namespace kronecker {
+        // minBits of the integers that are never packed
+        constexpr std::size_t none = static_cast<std::size_t>(-1);
+    }
+
+    // Integer in which the polynomials over Integer are packed. Boost numbers
+    //  are packed in their own type, so with gmp the product uses its FFT, and
+    //  every other Integer is packed in a cpp_int. It may be specialized by any
+    //  Integer, with widen and narrow converting from and to Wide.
+    //  Zxelem packs the products whose coefficients add at least minBits bits.
+    //  The products of machine integers are always faster than the packing
+    template<class Integer, class = void>
+    struct KroneckerPacking {
+        using Wide = bmp::cpp_int;
+
+        static constexpr std::size_t minBits = kronecker::none;
+
+        static Wide widen(const Integer &n) { return Wide(n); }
+
+        static Integer narrow(const Wide &n) { return n.template convert_to<Integer>(); }
+    };
+
+    template<class Integer>
+    struct KroneckerPacking<Integer, std::enable_if_t<bmp::is_number<Integer>::value>> {
+        using Wide = Integer;
+
+        static constexpr std::size_t minBits = 0;
+
+        static const Wide &widen(const Integer &n) { return n; }
+
+        static const Integer &narrow(const Wide &n) { return n; }
+    };
+
+    /**
+     * Products in Z[X] with Kronecker substitution
+     *
+     * Description:
+     *  mul computes r = a*b, where a has n coefficients and b has m, with a
+     *   single product of integers of about (n + m) slot bits. The absolute
+     *   values of the coefficients are written in slots of slot bits of a
+     *   buffer of 64-bit limbs, the packed integers are multiplied by the
+     *   backend of KroneckerPacking<Integer>::Wide and the slots of the
+     *   product are the coefficients of a*b.
+     *  The positive and the negative coefficients are packed apart, and the
+     *   packed integer is their difference. The slots of the product are then
+     *   balanced digits: a slot of value d >= 2^{slot-1} is the coefficient
+     *   d - 2^slot, which carries one to the next slot.
+     *  The limbs of Wide are read and written with limbs and fromLimbs, which
+     *   are overloaded for cpp_int and, with that backend, for gmp.
+     *
+     * Theoretical background:
+     *  a(2^slot) b(2^slot) = (a*b)(2^slot). If the coefficients of a and b
+     *   have at most ba and bb bits, every coefficient of a*b is smaller than
+     *   min(n, m) 2^{ba+bb} in absolute value, which is smaller than 2^{slot-1}
+     *   for slot = ba + bb + bits(min(n, m)) + 1, so the balanced digits of
+     *   slot bits in base 2^slot are exactly the coefficients.
+     *
+     * Complexity:
+     *  One product of integers of n slot and m slot bits, plus O((n + m) slot)
+     *   bit operations to pack and unpack
+     */
+    namespace kronecker {
+        // Absolute value of n in limbs of 64 bits, least significant first
+        template<unsigned MinBits, unsigned MaxBits, bmp::cpp_integer_type SignType, bmp::cpp_int_check_type Checked,
+                class Allocator, bmp::expression_template_option ET>
+        void limbs(const bmp::number<bmp::cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ET> &n,
+                   std::vector<std::uint64_t> &ret) {
+            ret.clear();
+            bmp::export_bits(n, std::back_inserter(ret), 64, false);
+        }
+
+        template<unsigned MinBits, unsigned MaxBits, bmp::cpp_integer_type SignType, bmp::cpp_int_check_type Checked,
+                class Allocator, bmp::expression_template_option ET>
+        void fromLimbs(bmp::number<bmp::cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ET> &n,
+                       const std::uint64_t *l, std::size_t size) {
+            n = 0;
+            bmp::import_bits(n, l, l + size, 64, false);
+        }
+
+#ifdef ALCP_BIG_INT_GMP
+        template<bmp::expression_template_option ET>
+        void limbs(const bmp::number<bmp::gmp_int, ET> &n, std::vector<std::uint64_t> &ret) {
+            ret.resize((mpz_sizeinbase(n.backend().data(), 2) + 63) / 64);
+            std::size_t size = 0;
+            mpz_export(ret.data(), &size, -1, sizeof(std::uint64_t), 0, 0, n.backend().data());
+            ret.resize(std::max<std::size_t>(size, 1));
+            if (size == 0)
+                ret[0] = 0;
+        }
+
+        template<bmp::expression_template_option ET>
+        void fromLimbs(bmp::number<bmp::gmp_int, ET> &n, const std::uint64_t *l, std::size_t size) {
+            mpz_import(n.backend().data(), size, -1, sizeof(std::uint64_t), 0, 0, l);
+        }
+#endif
+
+        template<class Wide>
+        std::size_t bits(const Wide &n) {
+            return n == 0 ? 0 : bmp::msb(Wide(abs(n))) + 1;
+        }
+
+        // Buffer of slots of slot bits
+        class Slots {
+        public:
+            Slots(std::size_t count, std::size_t slot) : _slot(slot), _l((count * slot + 63) / 64 + 1, 0) { }
+
+            // The buffer is the absolute value of n
+            template<class Wide>
+            Slots(const Wide &n, std::size_t count, std::size_t slot) : _slot(slot) {
+                limbs(n, _l);
+                _l.resize(std::max(_l.size(), (count * slot + 63) / 64) + 1, 0);
+            }
+
+            // Adds v to slot i, which must be zero
+            void set(std::size_t i, const std::vector<std::uint64_t> &v) {
+                const std::size_t first = i * _slot / 64, shift = i * _slot % 64;
+                for (std::size_t j = 0; j < v.size() && first + j < _l.size(); ++j) {
+                    _l[first + j] |= v[j] << shift;
+                    if (shift != 0 && first + j + 1 < _l.size())
+                        _l[first + j + 1] |= v[j] >> (64 - shift);
+                }
+            }
+
+            // The value of slot i in r, with one extra limb
+            void get(std::size_t i, std::vector<std::uint64_t> &r) const {
+                const std::size_t first = i * _slot / 64, shift = i * _slot % 64;
+                const std::size_t size = (_slot + 63) / 64 + 1;
+                r.assign(size, 0);
+                for (std::size_t j = 0; j < size && first + j < _l.size(); ++j) {
+                    r[j] = _l[first + j] >> shift;
+                    if (shift != 0 && first + j + 1 < _l.size())
+                        r[j] |= _l[first + j + 1] << (64 - shift);
+                }
+                mask(r);
+            }
+
+            // r mod 2^slot
+            void mask(std::vector<std::uint64_t> &r) const {
+                for (std::size_t j = _slot / 64; j < r.size(); ++j)
+                    r[j] &= j == _slot / 64 ? (std::uint64_t(1) << _slot % 64) - 1 : 0;
+            }
+
+            const std::uint64_t *data() const { return _l.data(); }
+
+            std::size_t size() const { return _l.size(); }
+
+        private:
+            std::size_t _slot;
+            std::vector<std::uint64_t> _l;
+        };
+
+        // sum_i c[i] 2^{slot i}
+        template<class Wide>
+        Wide pack(const std::vector<Wide> &c, std::size_t slot) {
+            Slots positive(c.size(), slot), negative(c.size(), slot);
+            bool anyNegative = false;
+            std::vector<std::uint64_t> l;
+            for (std::size_t i = 0; i < c.size(); ++i) {
+                if (c[i] == 0)
+                    continue;
+                limbs(c[i], l);
+                if (c[i] < 0) {
+                    negative.set(i, l);
+                    anyNegative = true;
+                }
+                else
+                    positive.set(i, l);
+            }
+            Wide ret, neg;
+            fromLimbs(ret, positive.data(), positive.size());
+            if (anyNegative) {
+                fromLimbs(neg, negative.data(), negative.size());
+                ret -= neg;
+            }
+            return ret;
+        }
+
+        // r[0..count) = the balanced digits of slot bits of n
+        template<class Integer, class Wide>
+        void unpack(Integer *r, const Wide &n, std::size_t count, std::size_t slot) {
+            using Packing = KroneckerPacking<Integer>;
+            const Slots slots(n, count, slot);
+            const bool negative = n < 0;
+            std::vector<std::uint64_t> d;
+            bool carry = false;
+            Wide coef;
+            for (std::size_t i = 0; i < count; ++i) {
+                slots.get(i, d);
+                for (std::size_t j = 0; carry && j < d.size(); ++j)
+                    carry = ++d[j] == 0;
+                // d >= 2^{slot-1}, including d = 2^slot, is d - 2^slot
+                const bool high = (d[(slot - 1) / 64] >> (slot - 1) % 64 & 1) != 0 ||
+                                  (slot % 64 == 0 ? d[slot / 64] : d[slot / 64] >> slot % 64) != 0;
+                if (high) {
+                    for (auto &limb : d)
+                        limb = ~limb;
+                    for (std::size_t j = 0; j < d.size() && ++d[j] == 0; ++j) { }
+                    slots.mask(d);
+                }
+                carry = high;
+                fromLimbs(coef, d.data(), d.size());
+                r[i] = Packing::narrow(high != negative ? Wide(-coef) : coef);
+            }
+        }
+
+        // r[0..n+m-1) = a[0..n) * b[0..m). r may not overlap a or b, but a may
+        //  be b for squares
+        template<class Integer>
+        void mul(Integer *r, const Integer *a, std::size_t n, const Integer *b, std::size_t m) {
+            using Packing = KroneckerPacking<Integer>;
+            using Wide = typename Packing::Wide;
+
+            std::size_t bitsA = 0, bitsB = 0;
+            std::vector<Wide> wa(n), wb;
+            for (std::size_t i = 0; i < n; ++i) {
+                wa[i] = Packing::widen(a[i]);
+                bitsA = std::max(bitsA, bits(wa[i]));
+            }
+            const bool square = a == b && n == m;
+            if (square)
+                bitsB = bitsA;
+            else {
+                wb.resize(m);
+                for (std::size_t i = 0; i < m; ++i) {
+                    wb[i] = Packing::widen(b[i]);
+                    bitsB = std::max(bitsB, bits(wb[i]));
+                }
+            }
+            if (bitsA == 0 || bitsB == 0) {
+                std::fill(r, r + n + m - 1, Packing::narrow(Wide(0)));
+                return;
+            }
+
+            const std::size_t slot = bitsA + bitsB + bits(Wide(std::min(n, m))) + 1;
+            const Wide pa = pack(wa, slot);
+            const Wide c(square ? Wide(pa * pa) : Wide(pa * pack(wb, slot)));
+            unpack(r, c, n + m - 1, slot);
+        }
+    }
+}
+
+#endif // __KRONECKER_HPP
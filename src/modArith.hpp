@@ -0,0 +1,455 @@
+#ifndef __MOD_ARITH_HPP
+#define __MOD_ARITH_HPP
+
+#include <cstdint>      // std::uint64_t
+#include <type_traits>  // std::enable_if_t, std::is_integral, std::integral_constant
+
+#include "types.hpp"
+#include "generalPurpose.hpp"   // eea, powFits
+
+namespace alcp {
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    // Built-in integers that fit in a machine word, e.g. not __int128
+    template<class Int>
+    struct isWordInteger : std::integral_constant<bool,
+            std::is_integral<Int>::value && sizeof(Int) <= sizeof(std::uint64_t)> { };
+
+    /**
+     * Modulus of Z/pZ
+     *
+     * Description:
+     *  Stores the modulus p of the ring together with whatever constants are
+     *   needed to reduce modulo p. All the operations assume that their
+     *   arguments are already reduced, i.e. that 0 <= a, b < p.
+     *  This generic version is used for the integer types without a fast
+     *   path (e.g. Boost multiprecision or __int128) and just relies on
+     *   operator%. When (p-1)^2 does not fit in a bounded Integer (e.g.
+     *   __int128 with p > 2^63) the products are computed by doubling and
+     *   adding, so that no intermediate value exceeds 2p.
+     */
+    template<class Integer, class = void>
+    class Modulus {
+    public:
+        Modulus() = default;
+
+        explicit Modulus(const Integer &p) : _p(p), _productFits(powFits(Integer(p - 1), 2)) { }
+
+        explicit operator Integer() const { return _p; }
+
+        // Reduces an arbitrary integer into [0, p)
+        Integer reduce(Integer n) const {
+            n %= _p;
+            if (n < 0)
+                n += _p;
+            return n;
+        }
+
+        // a + b may not be representable when p is close to the bound of Integer
+        Integer add(const Integer &a, const Integer &b) const {
+            return a >= _p - b ? Integer(a - (_p - b)) : Integer(a + b);
+        }
+
+        Integer sub(const Integer &a, const Integer &b) const {
+            return a >= b ? Integer(a - b) : Integer(a + (_p - b));
+        }
+
+        Integer neg(const Integer &a) const {
+            return a == 0 ? a : Integer(_p - a);
+        }
+
+        Integer mul(const Integer &a, const Integer &b) const {
+            if (_productFits)
+                return (a * b) % _p;
+            Integer r = 0, x = a;
+            for (Integer e = b; e != 0; e /= 2) {
+                if (e % 2 != 0)
+                    r = add(r, x);
+                x = add(x, x);
+            }
+            return r;
+        }
+
+        // Precondition: gcd(a, p) = 1
+        Integer inv(const Integer &a) const {
+            Integer x, y;
+            eea(a, _p, x, y);
+            return reduce(x);
+        }
+
+        bool operator==(const Modulus &rhs) const { return _p == rhs._p; }
+
+        bool operator!=(const Modulus &rhs) const { return _p != rhs._p; }
+
+    private:
+        Integer _p = Integer();
+        // Whether (p-1)^2 is representable as an Integer
+        bool _productFits = true;
+    };
+
+    // Number of bits of n
+    constexpr unsigned bitLength(std::uint64_t n) {
+        unsigned k = 0;
+        for (; n != 0; n >>= 1)
+            ++k;
+        return k;
+    }
+
+    // mu = floor(2^{2k}/p) where k is the number of bits of p
+    constexpr std::uint64_t barrettConstant(std::uint64_t p) {
+        return static_cast<std::uint64_t>((uint128_t(1) << (2 * bitLength(p))) / p);
+    }
+
+    // Reduces x < p^2 modulo p, where k is the number of bits of p and mu its Barrett constant
+    constexpr std::uint64_t barrettReduce(uint128_t x, std::uint64_t p, unsigned k, std::uint64_t mu) {
+        std::uint64_t q = static_cast<std::uint64_t>(
+                (static_cast<uint128_t>(static_cast<std::uint64_t>(x >> (k - 1))) * mu) >> (k + 1));
+        uint128_t r = x - static_cast<uint128_t>(q) * p;
+        while (r >= p)
+            r -= p;
+        return static_cast<std::uint64_t>(r);
+    }
+
+    // muWide = floor((2^128 - 1)/p), the constant of barrettReduceWide
+    constexpr uint128_t barrettWideConstant(std::uint64_t p) {
+        return ~static_cast<uint128_t>(0) / p;
+    }
+
+    // Reduces an arbitrary x modulo p. barrettReduce is only valid for x < p^2,
+    //  so larger values use Barrett's reduction with 2^128 instead of 2^{2k}:
+    //  q = floor(x*muWide/2^128) is at most two less than floor(x/p), and the
+    //  high half of x*muWide takes four 64x64->128 multiplications, with no
+    //  128-bit division
+    constexpr std::uint64_t barrettReduceWide(uint128_t x, std::uint64_t p, unsigned k, std::uint64_t mu,
+                                              uint128_t muWide) {
+        if (x < static_cast<uint128_t>(p) * p)
+            return barrettReduce(x, p, k, mu);
+        const std::uint64_t x0 = static_cast<std::uint64_t>(x), x1 = static_cast<std::uint64_t>(x >> 64);
+        const std::uint64_t m0 = static_cast<std::uint64_t>(muWide), m1 = static_cast<std::uint64_t>(muWide >> 64);
+        const uint128_t low = static_cast<uint128_t>(x0) * m0;
+        const uint128_t mid0 = static_cast<uint128_t>(x0) * m1, mid1 = static_cast<uint128_t>(x1) * m0;
+        const uint128_t carry = (low >> 64) + static_cast<std::uint64_t>(mid0) + static_cast<std::uint64_t>(mid1);
+        const uint128_t q = static_cast<uint128_t>(x1) * m1 + (mid0 >> 64) + (mid1 >> 64) + (carry >> 64);
+        uint128_t r = x - q * p;
+        while (r >= p)
+            r -= p;
+        return static_cast<std::uint64_t>(r);
+    }
+
+    /**
+     * Shoup's multiplication by a fixed operand
+     *
+     * Description:
+     *  When many residues are multiplied by the same w < p, precompute
+     *   w' = floor(w*2^64/p) once with shoupConstant. Then shoupMul computes
+     *   a*w (mod p) with two 64-bit multiplications and no division.
+     *
+     * Theoretical background:
+     *  q = floor(a*w'/2^64) is at most one less than floor(a*w/p), so
+     *   a*w - q*p lies in [0, 2p). Since p < 2^63 it can be computed modulo
+     *   2^64 and it is reduced with one subtraction.
+     */
+    constexpr std::uint64_t shoupConstant(std::uint64_t w, std::uint64_t p) {
+        return static_cast<std::uint64_t>((static_cast<uint128_t>(w) << 64) / p);
+    }
+
+    constexpr std::uint64_t shoupMul(std::uint64_t a, std::uint64_t w, std::uint64_t wShoup, std::uint64_t p) {
+        std::uint64_t q = static_cast<std::uint64_t>((static_cast<uint128_t>(a) * wShoup) >> 64);
+        std::uint64_t r = a * w - q * p;
+        return r >= p ? r - p : r;
+    }
+
+    /**
+     * Barrett reduction for machine integers
+     *
+     * Description:
+     *  Modulus of Z/pZ for every p < 2^63 that fits in a built-in integer.
+     *  Products are computed in 128 bits and then reduced with Barrett's
+     *   algorithm, so no operation overflows and there is no hardware
+     *   division in the multiplication.
+     *
+     * Theoretical background:
+     *  Let k be the number of bits of p, so 2^{k-1} <= p < 2^k, and let
+     *   mu = floor(2^{2k}/p) < 2^{k+1}, which is precomputed once.
+     *  For x < p^2 < 2^{2k} the estimate
+     *   q = floor(floor(x/2^{k-1}) * mu / 2^{k+1})
+     *   satisfies floor(x/p) - 2 <= q <= floor(x/p), so x - q*p is in [0, 3p)
+     *   and it is reduced with at most two subtractions.
+     *  Both x/2^{k-1} < 2^{k+1} <= 2^64 and mu <= 2^64 fit in 64 bits, and
+     *   their product fits in 128 bits.
+     *  Sums of products, which may exceed p^2, are reduced with the constant
+     *   of 2^128 (see barrettReduceWide).
+     *
+     * Complexity:
+     *  Two 64x64->128 multiplications per modular product, and at most six
+     *   per reduction of a 128-bit integer
+     */
+    template<class Integer>
+    class Modulus<Integer, std::enable_if_t<isWordInteger<Integer>::value>> {
+    public:
+        Modulus() = default;
+
+        explicit Modulus(Integer p) :
+                _p(static_cast<std::uint64_t>(p)), _mu(barrettConstant(_p)), _k(bitLength(_p)),
+                _muWide(barrettWideConstant(_p)) { }
+
+        explicit operator Integer() const { return static_cast<Integer>(_p); }
+
+        Integer reduce(Integer n) const {
+            n %= static_cast<Integer>(_p);
+            if (n < 0)
+                n += static_cast<Integer>(_p);
+            return n;
+        }
+
+        Integer add(Integer a, Integer b) const {
+            std::uint64_t r = static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b);
+            if (r >= _p)
+                r -= _p;
+            return static_cast<Integer>(r);
+        }
+
+        // p is added through a mask: a branch would be mispredicted half of the
+        //  times on random residues
+        Integer sub(Integer a, Integer b) const {
+            const std::uint64_t ua = static_cast<std::uint64_t>(a), ub = static_cast<std::uint64_t>(b);
+            return static_cast<Integer>(ua - ub + (_p & (0 - static_cast<std::uint64_t>(ua < ub))));
+        }
+
+        Integer neg(Integer a) const {
+            return a == 0 ? a : static_cast<Integer>(_p - static_cast<std::uint64_t>(a));
+        }
+
+        Integer mul(Integer a, Integer b) const {
+            return static_cast<Integer>(reduceProduct(
+                    static_cast<uint128_t>(static_cast<std::uint64_t>(a)) * static_cast<std::uint64_t>(b)));
+        }
+
+        Integer inv(Integer a) const {
+            Integer x, y;
+            eea(a, static_cast<Integer>(_p), x, y);
+            return reduce(x);
+        }
+
+        // Reduces x < p^2, e.g. the product of two reduced residues
+        std::uint64_t reduceProduct(uint128_t x) const {
+            return barrettReduce(x, _p, _k, _mu);
+        }
+
+        // Reduces an arbitrary 128-bit integer, e.g. a sum of products
+        std::uint64_t reduceWide(uint128_t x) const {
+            return barrettReduceWide(x, _p, _k, _mu, _muWide);
+        }
+
+        bool operator==(const Modulus &rhs) const { return _p == rhs._p; }
+
+        bool operator!=(const Modulus &rhs) const { return _p != rhs._p; }
+
+    private:
+        std::uint64_t _p = 0;
+        std::uint64_t _mu = 0;
+        unsigned _k = 0;
+        uint128_t _muWide = 0;
+    };
+
+    /**
+     * Deterministic Miller-Rabin test for 64-bit integers
+     *
+     * Description:
+     *  Checking the bases 2, 3, ..., 37 is enough for every n < 2^64, so the
+     *   test is exact. It is constexpr so the primality of a modulus given
+     *   as a template argument is checked at compile time.
+     */
+    constexpr bool isPrime64(std::uint64_t n) {
+        if (n < 2)
+            return false;
+        const std::uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+        for (std::uint64_t b : bases)
+            if (n % b == 0)
+                return n == b;
+        std::uint64_t s = n - 1;
+        int r = 0;
+        for (; s % 2 == 0; s /= 2)
+            ++r;
+        for (std::uint64_t b : bases) {
+            std::uint64_t a = 1, base = b, e = s;
+            for (; e != 0; e /= 2) {
+                if (e % 2 != 0)
+                    a = static_cast<std::uint64_t>(static_cast<uint128_t>(a) * base % n);
+                base = static_cast<std::uint64_t>(static_cast<uint128_t>(base) * base % n);
+            }
+            if (a == 1 || a == n - 1)
+                continue;
+            bool composite = true;
+            for (int i = 1; i < r && composite; ++i) {
+                a = static_cast<std::uint64_t>(static_cast<uint128_t>(a) * a % n);
+                composite = a != n - 1;
+            }
+            if (composite)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Modulus known at compile time
+     *
+     * Description:
+     *  Same reduction as Modulus, but p and its Barrett constants are
+     *   compile-time constants. The type is empty, so the elements that
+     *   use it take just the space of their representative.
+     */
+    template<long long P>
+    class StaticModulus {
+        static_assert(P > 1, "The modulus must be greater than one.");
+    public:
+        static constexpr std::uint64_t p = static_cast<std::uint64_t>(P);
+        static constexpr unsigned k = bitLength(p);
+        static constexpr std::uint64_t mu = barrettConstant(p);
+        static constexpr uint128_t muWide = barrettWideConstant(p);
+
+        constexpr StaticModulus() = default;
+
+        explicit constexpr operator long long() const { return P; }
+
+        constexpr long long reduce(long long n) const {
+            return n % P < 0 ? n % P + P : n % P;
+        }
+
+        constexpr long long add(long long a, long long b) const {
+            return static_cast<long long>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b) >= p ?
+                                          static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b) - p :
+                                          static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+        }
+
+        constexpr long long sub(long long a, long long b) const {
+            return a >= b ? a - b : static_cast<long long>(static_cast<std::uint64_t>(a) + (p - static_cast<std::uint64_t>(b)));
+        }
+
+        constexpr long long neg(long long a) const {
+            return a == 0 ? a : P - a;
+        }
+
+        constexpr long long mul(long long a, long long b) const {
+            return static_cast<long long>(barrettReduce(
+                    static_cast<uint128_t>(static_cast<std::uint64_t>(a)) * static_cast<std::uint64_t>(b), p, k, mu));
+        }
+
+        long long inv(long long a) const {
+            long long x, y;
+            eea(a, P, x, y);
+            return reduce(x);
+        }
+
+        constexpr std::uint64_t reduceWide(uint128_t x) const {
+            return barrettReduceWide(x, p, k, mu, muWide);
+        }
+
+        constexpr bool operator==(const StaticModulus &) const { return true; }
+
+        constexpr bool operator!=(const StaticModulus &) const { return false; }
+    };
+
+    template<long long P> constexpr std::uint64_t StaticModulus<P>::p;
+    template<long long P> constexpr unsigned StaticModulus<P>::k;
+    template<long long P> constexpr std::uint64_t StaticModulus<P>::mu;
+    template<long long P> constexpr uint128_t StaticModulus<P>::muWide;
+
+    // Modular operations on an arbitrary quotient ring. They are overloaded
+    //  for Modulus, and the generic version just reduces with operator%
+    template<class T>
+    T addMod(const T &a, const T &b, const T &m) { return (a + b) % m; }
+
+    template<class T>
+    T subMod(const T &a, const T &b, const T &m) { return (a - b) % m; }
+
+    template<class T>
+    T negMod(const T &a, const T &m) { return (-a) % m; }
+
+    template<class T>
+    T mulMod(const T &a, const T &b, const T &m) { return (a * b) % m; }
+
+    template<class T>
+    T invMod(const T &a, const T &m) {
+        T x, y;
+        eea(a, m, x, y);
+        return x % m;
+    }
+
+    template<class Int, class E>
+    Int addMod(const Int &a, const Int &b, const Modulus<Int, E> &m) { return m.add(a, b); }
+
+    template<class Int, class E>
+    Int subMod(const Int &a, const Int &b, const Modulus<Int, E> &m) { return m.sub(a, b); }
+
+    template<class Int, class E>
+    Int negMod(const Int &a, const Modulus<Int, E> &m) { return m.neg(a); }
+
+    template<class Int, class E>
+    Int mulMod(const Int &a, const Int &b, const Modulus<Int, E> &m) { return m.mul(a, b); }
+
+    template<class Int, class E>
+    Int invMod(const Int &a, const Modulus<Int, E> &m) { return m.inv(a); }
+
+    template<class Int>
+    std::enable_if_t<isWordInteger<Int>::value, Int>
+    reduceWideMod(uint128_t x, const Modulus<Int> &m) { return static_cast<Int>(m.reduceWide(x)); }
+
+    template<long long P>
+    constexpr long long addMod(long long a, long long b, StaticModulus<P> m) { return m.add(a, b); }
+
+    template<long long P>
+    constexpr long long subMod(long long a, long long b, StaticModulus<P> m) { return m.sub(a, b); }
+
+    template<long long P>
+    constexpr long long negMod(long long a, StaticModulus<P> m) { return m.neg(a); }
+
+    template<long long P>
+    constexpr long long mulMod(long long a, long long b, StaticModulus<P> m) { return m.mul(a, b); }
+
+    template<long long P>
+    long long invMod(long long a, StaticModulus<P> m) { return m.inv(a); }
+
+    template<long long P>
+    constexpr long long reduceWideMod(uint128_t x, StaticModulus<P> m) { return static_cast<long long>(m.reduceWide(x)); }
+
+    // Shoup's multiplication, only for moduli p < 2^63 stored in a machine word
+    template<class Int>
+    std::enable_if_t<isWordInteger<Int>::value && std::is_signed<Int>::value, std::uint64_t>
+    shoupConstantMod(Int w, const Modulus<Int> &m) {
+        return shoupConstant(static_cast<std::uint64_t>(w), static_cast<std::uint64_t>(static_cast<Int>(m)));
+    }
+
+    template<class Int>
+    std::enable_if_t<isWordInteger<Int>::value && std::is_signed<Int>::value, Int>
+    shoupMulMod(Int a, Int w, std::uint64_t wShoup, const Modulus<Int> &m) {
+        return static_cast<Int>(shoupMul(static_cast<std::uint64_t>(a), static_cast<std::uint64_t>(w),
+                                         wShoup, static_cast<std::uint64_t>(static_cast<Int>(m))));
+    }
+
+    template<long long P>
+    constexpr std::uint64_t shoupConstantMod(long long w, StaticModulus<P>) {
+        return shoupConstant(static_cast<std::uint64_t>(w), StaticModulus<P>::p);
+    }
+
+    template<long long P>
+    constexpr long long shoupMulMod(long long a, long long w, std::uint64_t wShoup, StaticModulus<P>) {
+        return static_cast<long long>(shoupMul(static_cast<std::uint64_t>(a), static_cast<std::uint64_t>(w),
+                                               wShoup, StaticModulus<P>::p));
+    }
+
+    // Exponentiation by squaring, a^e (mod m) with a reduced and e >= 0
+    template<class Int, class E, class U>
+    Int powMod(Int a, U e, const Modulus<Int, E> &m) {
+        Int result = m.reduce(1);
+        while (e != 0) {
+            if (e % 2 != 0)
+                result = m.mul(result, a);
+            a = m.mul(a, a);
+            e /= 2;
+        }
+        return result;
+    }
+}
+
+#endif // __MOD_ARITH_HPP
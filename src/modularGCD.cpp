@@ -10,6 +10,7 @@
 #include "integerCRA.hpp"
 #include "zxelem.hpp"
 #include "types.hpp"
+#include "hybridInt.hpp"
 
 namespace alcp {
     big_int randomPrime() {
@@ -23,10 +24,33 @@ namespace alcp {
         return a;
     }
 
-    Fpxelem_b redModP(const Zxelem_b &a, const Fp_b &f) {
+    // The primes are smaller than 2^31, so the residues fit in a long long
+    template<class Integer>
+    Integer toInteger(const big_int &n) {
+        return Integer(static_cast<long long>(n));
+    }
+
+    template<class Integer>
+    big_int toBigInt(const Integer &n) {
+        return big_int(static_cast<long long>(n));
+    }
+
+    template<class Integer>
+    Fpxelem_b redModP(const Zxelem<Integer> &a, const Fp_b &f) {
+        const Integer p = toInteger<Integer>(f.getP());
         std::vector<Fpelem_b> ret(a.deg() + 1);
         for (std::size_t i = 0; i <= a.deg(); ++i)
-            ret[i] = f.get(a[i]);
+            ret[i] = f.get(toBigInt(a[i] % p));
+        return ret;
+    }
+
+    // Symmetric representation of a \in Fp[X] in Z[X]
+    template<class Integer>
+    Zxelem<Integer> liftSym(const Fpxelem_b &a) {
+        const Zxelem_b aux(a);
+        std::vector<Integer> ret;
+        for (const auto &coef : aux)
+            ret.push_back(toInteger<Integer>(coef));
         return ret;
     }
 
@@ -35,30 +59,33 @@ namespace alcp {
      *  Given A, B \in Z[X] nonzero, it obtains gcd (A, B) via modular
      *  reduction.
      * */
-    Zxelem_b modularGCD(Zxelem_b a, Zxelem_b b) {
+    template<class Integer>
+    Zxelem<Integer> modularGCD(Zxelem<Integer> a, Zxelem<Integer> b) {
         if(a == 0)
             return b;
         if(b == 0)
             return a;
-        big_int ia = content(a);
+        Integer ia = content(a);
         a /= ia;
-        big_int ib = content(b);
+        Integer ib = content(b);
         b /= ib;
         //Compute coefficient bound of gcd(a, b)
-        big_int ic = gcd(ia, ib);
-        big_int g = gcd(a.lc(), b.lc());
-        big_int q = 0;
-        Zxelem_b h = static_cast<big_int>(0);
-        Zxelem_b c;
+        Integer ic = gcd(ia, ib);
+        Integer g = gcd(a.lc(), b.lc());
+        Integer q = 0;
+        Zxelem<Integer> h = Integer(0);
+        Zxelem<Integer> c;
         big_int p;
         std::size_t n = std::min(a.deg(), b.deg());
-        big_int limit = (1 << n) * g * std::min(normInf(a), normInf(b));
+        Integer limit = fastPow(Integer(2), n) * g * std::min(normInf(a), normInf(b));
         bool fst = true;
 
         while (true) {
+            Integer ip;
             do {
                 p = randomPrime();
-            } while (g % p == 0);
+                ip = toInteger<Integer>(p);
+            } while (g % ip == 0);
 
             // These variables ought be defined inside the loop since they are p-dependent
             Fp_b f(p);
@@ -68,23 +95,23 @@ namespace alcp {
             Fpxelem_b cp = gcd(ap, bp);
             if (cp.deg() == 0)
                 cp = f.get(1);
-            Fpelem_b gp = f.get(g);
+            Fpelem_b gp = f.get(toBigInt(g % ip));
 
             // Normalize so gp = lcoeff(cp)
             cp = gp * cp.lc().inv() * cp;
 
             // Previous unlucky reduction of first image
             if (fst || cp.deg() < n) {
-                q = p;
-                h = Zxelem_b(cp);
+                q = ip;
+                h = liftSym<Integer>(cp);
                 n = cp.deg();
                 fst = false;
             }
-            if(cp.deg() == n) {
+            else if(cp.deg() == n) {
                 for (std::size_t i = 0; i <= h.deg(); ++i) {
-                    h[i] = integerCRA({q, p}, {h[i], static_cast<big_int>(cp[i])});
+                    h[i] = integerCRA<Integer>({q, ip}, {h[i], toInteger<Integer>(static_cast<big_int>(cp[i]))});
                 }
-                q *= p;
+                q *= ip;
             }
             else if(cp.deg() > n)// Unlucky reduction
                 continue;
@@ -97,4 +124,8 @@ namespace alcp {
                 return ic;
         }
     }
+
+    template Zxelem_b modularGCD(Zxelem_b a, Zxelem_b b);
+
+    template Zxelem<HybridInt> modularGCD(Zxelem<HybridInt> a, Zxelem<HybridInt> b);
 }
@@ -5,7 +5,9 @@
 
 namespace alcp {
 	big_int randomPrime();
-    Zxelem_b modularGCD(Zxelem_b a, Zxelem_b b);
+    // Instantiated for big_int and HybridInt
+    template<class Integer>
+    Zxelem<Integer> modularGCD(Zxelem<Integer> a, Zxelem<Integer> b);
 }
 
 #endif //MODULARGCD_HPP
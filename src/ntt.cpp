@@ -0,0 +1,207 @@
+#include "ntt.hpp"
+
+#include <algorithm>    // std::copy
+#include <map>
+#include <memory>       // std::shared_ptr, std::make_shared
+#include <mutex>
+#include <vector>
+
+#include "modArith.hpp" // Modulus, shoupConstant, shoupMul, uint128_t
+
+namespace alcp {
+    namespace ntt {
+        namespace {
+            using Mod = Modulus<std::uint64_t>;
+
+            // Primes c 2^k + 1 with k >= 41
+            const std::uint64_t primes[3] = {
+                    65535ULL * (1ULL << 46) + 1,        // 4611615649683210241
+                    2097119ULL * (1ULL << 41) + 1,      // 4611613450659954689
+                    1048545ULL * (1ULL << 42) + 1       // 4611549678985543681
+            };
+
+            std::size_t transformSize(std::size_t n, std::size_t m) {
+                std::size_t size = 1;
+                while (size < n + m - 1)
+                    size *= 2;
+                return size;
+            }
+
+            std::uint64_t add(std::uint64_t a, std::uint64_t b, std::uint64_t p) {
+                const std::uint64_t r = a + b;
+                return r >= p ? r - p : r;
+            }
+
+            std::uint64_t sub(std::uint64_t a, std::uint64_t b, std::uint64_t p) {
+                return a - b + (p & (0 - static_cast<std::uint64_t>(a < b)));
+            }
+
+            // a^e mod p for a < p
+            std::uint64_t powMod(std::uint64_t a, std::uint64_t e, const Mod &mod) {
+                std::uint64_t ret = 1;
+                for (; e != 0; e /= 2) {
+                    if (e % 2 != 0)
+                        ret = mod.mul(ret, a);
+                    a = mod.mul(a, a);
+                }
+                return ret;
+            }
+
+            // Multiplication by a fixed residue
+            struct Shoup {
+                Shoup() = default;
+
+                Shoup(std::uint64_t w, std::uint64_t p) : w(w), wShoup(shoupConstant(w, p)) { }
+
+                std::uint64_t w = 0, wShoup = 0;
+            };
+
+            /**
+             * Twiddle factors modulo p for the transforms of every length up to
+             *  size, a power of two that divides p - 1. The ones of the
+             *  butterflies of half length len are w_{2 len}^j, stored at
+             *  [len + j], which does not depend on the length of the transform
+             */
+            class Twiddles {
+            public:
+                Twiddles(std::uint64_t p, std::size_t size) : _p(p), _size(size), _w(size), _iw(size) {
+                    const Mod mod(p);
+                    std::uint64_t a = 2;
+                    while (powMod(a, (p - 1) / 2, mod) != p - 1)
+                        ++a;
+                    std::uint64_t root = powMod(a, (p - 1) / size, mod), iroot = powMod(root, size - 1, mod);
+                    for (std::size_t len = size / 2; len >= 1; len /= 2) {
+                        std::uint64_t w = 1, iw = 1;
+                        for (std::size_t j = 0; j < len; ++j) {
+                            _w[len + j] = Shoup(w, p);
+                            _iw[len + j] = Shoup(iw, p);
+                            w = mod.mul(w, root);
+                            iw = mod.mul(iw, iroot);
+                        }
+                        root = mod.mul(root, root);
+                        iroot = mod.mul(iroot, iroot);
+                    }
+                }
+
+                std::size_t size() const { return _size; }
+
+                // Natural order to bit-reversed order. The members are copied
+                //  to locals, as the stores to a could alias them
+                void forward(std::uint64_t *a, std::size_t n) const {
+                    const std::uint64_t p = _p;
+                    const Shoup *tw = _w.data();
+                    for (std::size_t len = n / 2; len >= 1; len /= 2)
+                        for (std::size_t s = 0; s < n; s += 2 * len) {
+                            std::uint64_t *x = a + s, *y = a + s + len;
+                            const Shoup *w = tw + len;
+                            for (std::size_t j = 0; j < len; ++j) {
+                                const std::uint64_t u = x[j], v = y[j];
+                                x[j] = add(u, v, p);
+                                y[j] = shoupMul(sub(u, v, p), w[j].w, w[j].wShoup, p);
+                            }
+                        }
+                }
+
+                // Bit-reversed order to natural order, divided by n
+                void inverse(std::uint64_t *a, std::size_t n) const {
+                    const std::uint64_t p = _p;
+                    const Shoup *tw = _iw.data();
+                    for (std::size_t len = 1; len < n; len *= 2)
+                        for (std::size_t s = 0; s < n; s += 2 * len) {
+                            std::uint64_t *x = a + s, *y = a + s + len;
+                            const Shoup *w = tw + len;
+                            for (std::size_t j = 0; j < len; ++j) {
+                                const std::uint64_t u = x[j], v = shoupMul(y[j], w[j].w, w[j].wShoup, p);
+                                x[j] = add(u, v, p);
+                                y[j] = sub(u, v, p);
+                            }
+                        }
+                    const Shoup nInv(powMod(n % p, p - 2, Mod(p)), p);
+                    for (std::size_t i = 0; i < n; ++i)
+                        a[i] = shoupMul(a[i], nInv.w, nInv.wShoup, p);
+                }
+
+            private:
+                std::uint64_t _p;
+                std::size_t _size;
+                std::vector<Shoup> _w, _iw;
+            };
+
+            // The twiddle factors modulo p are computed once for the longest
+            //  transform so far. They are shared, so a longer transform in other
+            //  thread replaces them in the cache while they are in use
+            std::shared_ptr<const Twiddles> twiddles(std::uint64_t p, std::size_t size) {
+                static std::mutex lock;
+                static std::map<std::uint64_t, std::shared_ptr<const Twiddles>> cache;
+                std::lock_guard<std::mutex> guard(lock);
+                auto &entry = cache[p];
+                if (entry == nullptr || entry->size() < size)
+                    entry = std::make_shared<const Twiddles>(p, size);
+                return entry;
+            }
+
+            // r[0..n+m-1) = a*b mod q, where the residues of a and b are reduced
+            //  modulo q here, as they may come from a larger p
+            void convolution(std::uint64_t *r, const std::uint64_t *a, std::size_t n, const std::uint64_t *b,
+                             std::size_t m, std::uint64_t q) {
+                const std::size_t size = transformSize(n, m);
+                const std::shared_ptr<const Twiddles> transform = twiddles(q, size);
+                const Mod mod(q);
+                std::vector<std::uint64_t> fa(size, 0);
+                for (std::size_t i = 0; i < n; ++i)
+                    fa[i] = a[i] >= q ? a[i] - q : a[i];
+                transform->forward(fa.data(), size);
+                if (a == b && n == m) {
+                    for (std::size_t i = 0; i < size; ++i)
+                        fa[i] = mod.mul(fa[i], fa[i]);
+                }
+                else {
+                    std::vector<std::uint64_t> fb(size, 0);
+                    for (std::size_t i = 0; i < m; ++i)
+                        fb[i] = b[i] >= q ? b[i] - q : b[i];
+                    transform->forward(fb.data(), size);
+                    for (std::size_t i = 0; i < size; ++i)
+                        fa[i] = mod.mul(fa[i], fb[i]);
+                }
+                transform->inverse(fa.data(), size);
+                std::copy(fa.begin(), fa.begin() + (n + m - 1), r);
+            }
+        }
+
+        bool direct(std::uint64_t p, std::size_t n, std::size_t m) {
+            return (p - 1) % transformSize(n, m) == 0;
+        }
+
+        void mul(std::uint64_t *r, const std::uint64_t *a, std::size_t n, const std::uint64_t *b, std::size_t m,
+                 std::uint64_t p) {
+            if (direct(p, n, m)) {
+                convolution(r, a, n, b, m, p);
+                return;
+            }
+            const std::size_t len = n + m - 1;
+            std::vector<std::uint64_t> r0(len), r1(len), r2(len);
+            convolution(r0.data(), a, n, b, m, primes[0]);
+            convolution(r1.data(), a, n, b, m, primes[1]);
+            convolution(r2.data(), a, n, b, m, primes[2]);
+
+            // Garner: x = x0 + q0 x1 + q0 q1 x2 with xi < qi. The inverses are a^{q-2}
+            const Mod m1(primes[1]), m2(primes[2]), mp(p);
+            const Shoup q0Inv1(powMod(primes[0] % primes[1], primes[1] - 2, m1), primes[1]);
+            const Shoup q0Inv2(powMod(primes[0] % primes[2], primes[2] - 2, m2), primes[2]);
+            const Shoup q1Inv2(powMod(primes[1] % primes[2], primes[2] - 2, m2), primes[2]);
+            const std::uint64_t q0p = primes[0] % p;
+            const std::uint64_t q0q1p = static_cast<std::uint64_t>(static_cast<uint128_t>(primes[0]) * primes[1] % p);
+            for (std::size_t i = 0; i < len; ++i) {
+                const std::uint64_t x0 = r0[i];
+                const std::uint64_t x01 = x0 >= primes[1] ? x0 - primes[1] : x0;
+                const std::uint64_t x1 = shoupMul(sub(r1[i], x01, primes[1]), q0Inv1.w, q0Inv1.wShoup, primes[1]);
+                const std::uint64_t x02 = x0 >= primes[2] ? x0 - primes[2] : x0;
+                const std::uint64_t x12 = x1 >= primes[2] ? x1 - primes[2] : x1;
+                const std::uint64_t t = shoupMul(sub(r2[i], x02, primes[2]), q0Inv2.w, q0Inv2.wShoup, primes[2]);
+                const std::uint64_t x2 = shoupMul(sub(t, x12, primes[2]), q1Inv2.w, q1Inv2.wShoup, primes[2]);
+                r[i] = mp.reduceWide(static_cast<uint128_t>(x0) + static_cast<uint128_t>(q0p) * x1 +
+                                     static_cast<uint128_t>(q0q1p) * x2);
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef __NTT_HPP
+#define __NTT_HPP
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+
+namespace alcp {
+    /**
+     * Products in GF(p)[X] with the number-theoretic transform
+     *
+     * Description:
+     *  The coefficients are the residues of the polynomials, reduced modulo
+     *   a prime p < modulusBound.
+     *  If p = c 2^k + 1 with 2^k at least the size of the product, the
+     *   product is computed with transforms modulo p itself. Otherwise it is
+     *   computed modulo three fixed primes of that form, which is the exact
+     *   product over Z, and then reduced modulo p with the CRT.
+     *  The forward transform is decimation in frequency, so its output is in
+     *   bit-reversed order, and the inverse is decimation in time from that
+     *   order, so there is no permutation of the coefficients. The twiddle
+     *   factors are multiplied with Shoup's algorithm. A square needs one
+     *   forward transform.
+     *
+     * Theoretical background:
+     *  If 2^k divides p - 1, a non-residue a gives the primitive 2^k-th root
+     *   of unity a^{(p-1)/2^k}. The transform of length N = 2^k evaluates a
+     *   polynomial at the N roots of unity, so for N >= n + m - 1 the product
+     *   of the evaluations of a and b gives a*b.
+     *  Every coefficient of a*b over Z is smaller than min(n, m) (p-1)^2 <
+     *   2^186, so it is determined by its residues modulo the three primes,
+     *   which are computed with Garner's algorithm.
+     *
+     * Complexity:
+     *  O(N log N) products modulo p, or three times that with the CRT, where
+     *   N is the power of two from n + m - 1
+     */
+    namespace ntt {
+        // Shoup's products need p < 2^63, and the fixed primes of the CRT are
+        //  just below 2^62
+        constexpr std::uint64_t modulusBound = std::uint64_t(1) << 62;
+
+        // Whether the products of n and m coefficients are computed modulo p directly
+        bool direct(std::uint64_t p, std::size_t n, std::size_t m);
+
+        // r[0..n+m-1) = a[0..n) * b[0..m) mod p. r may not overlap a or b,
+        //  but a may be b for squares
+        void mul(std::uint64_t *r, const std::uint64_t *a, std::size_t n, const std::uint64_t *b, std::size_t m,
+                 std::uint64_t p);
+    }
+}
+
+#endif // __NTT_HPP
@@ -0,0 +1,307 @@
+#ifndef __PACKED_COEFFICIENTS_HPP
+#define __PACKED_COEFFICIENTS_HPP
+
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <iterator>     // std::random_access_iterator_tag
+#include <type_traits>  // std::conditional_t
+#include <vector>
+
+#include "exceptions.hpp"
+
+namespace alcp {
+    /**
+     * How an element is stored in a PackedCoefficients
+     *
+     * Every element type that is stored packed specializes it with
+     *  Word: the type of the words of the element
+     *  Context: the shared data of its ring, which the element points to
+     *  width(ctx): the number of words of an element of that context
+     *  context(e), zero(ctx): the context of e and the zero of a context
+     *  read(ctx, w): the element whose words start at w
+     *  write(w, e): copies the words of e to w
+     */
+    template<class Felem>
+    struct CoefficientPacking;
+
+    /**
+     * Coefficients of a polynomial whose elements share a context
+     *
+     * Description:
+     *  Container with the interface of std::vector<Felem> that stores the
+     *   context of the ring once and the words of the elements one after
+     *   the other in a contiguous array, i.e. width(ctx) words per
+     *   coefficient instead of those words and a pointer.
+     *  Reading a const container returns an element by value. Otherwise
+     *   operator[] and the iterators return a Felem&, as std::vector does.
+     *   These references live in an element view that is built the first
+     *   time they are asked for and that holds the coefficients from then
+     *   on. data() is where the view is folded back: the non-const data()
+     *   drops the view, so it invalidates the references as a reallocation
+     *   would, and the const one copies the view into the words every time
+     *   it is called.
+     *  The words are accessible through data(), e.g. to use the kernels in
+     *   simdKernels.hpp on them.
+     */
+    template<class Felem>
+    class PackedCoefficients {
+    private:
+        using Packing = CoefficientPacking<Felem>;
+        using Word = typename Packing::Word;
+        using Context = typename Packing::Context;
+
+    public:
+        using value_type = Felem;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = Felem &;
+        using const_reference = Felem;
+
+        /**
+         * Iterators
+         *
+         * They hold the container and an index, so they do not build the
+         *  element view until they are dereferenced, and erase() or
+         *  begin() + n on the words stays cheap.
+         */
+        template<bool Const>
+        class Iterator {
+        private:
+            using Container = std::conditional_t<Const, const PackedCoefficients, PackedCoefficients>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Felem;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, void, Felem *>;
+            using reference = std::conditional_t<Const, Felem, Felem &>;
+
+            Iterator() = default;
+
+            Iterator(Container *c, std::size_t i) : _c(c), _i(i) { }
+
+            // iterator -> const_iterator
+            template<bool C = Const, class = std::enable_if_t<C>>
+            Iterator(const Iterator<false> &it) : _c(it._c), _i(it._i) { }
+
+            reference operator*() const { return (*_c)[_i]; }
+
+            reference operator[](difference_type n) const { return (*_c)[_i + n]; }
+
+            Iterator &operator++() { ++_i; return *this; }
+
+            Iterator operator++(int) { Iterator ret(*this); ++_i; return ret; }
+
+            Iterator &operator--() { --_i; return *this; }
+
+            Iterator operator--(int) { Iterator ret(*this); --_i; return ret; }
+
+            Iterator &operator+=(difference_type n) { _i += n; return *this; }
+
+            Iterator &operator-=(difference_type n) { _i -= n; return *this; }
+
+            friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+
+            friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+
+            friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+
+            friend difference_type operator-(const Iterator &lhs, const Iterator &rhs) {
+                return static_cast<difference_type>(lhs._i) - static_cast<difference_type>(rhs._i);
+            }
+
+            friend bool operator==(const Iterator &lhs, const Iterator &rhs) { return lhs._i == rhs._i; }
+
+            friend bool operator!=(const Iterator &lhs, const Iterator &rhs) { return lhs._i != rhs._i; }
+
+            friend bool operator<(const Iterator &lhs, const Iterator &rhs) { return lhs._i < rhs._i; }
+
+            friend bool operator>(const Iterator &lhs, const Iterator &rhs) { return lhs._i > rhs._i; }
+
+            friend bool operator<=(const Iterator &lhs, const Iterator &rhs) { return lhs._i <= rhs._i; }
+
+            friend bool operator>=(const Iterator &lhs, const Iterator &rhs) { return lhs._i >= rhs._i; }
+
+        private:
+            friend class Iterator<true>;
+            friend class PackedCoefficients;
+
+            Container *_c = nullptr;
+            std::size_t _i = 0;
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        PackedCoefficients() = default;
+
+        PackedCoefficients(size_type n, const Felem &value) : _ctx(Packing::context(value)) {
+            this->resize(n, value);
+        }
+
+        // From a range of elements convertible to Felem
+        template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+        PackedCoefficients(InputIt first, InputIt last) {
+            for (; first != last; ++first)
+                this->push_back(Felem(*first));
+        }
+
+        PackedCoefficients(const std::vector<Felem> &v) : PackedCoefficients(v.begin(), v.end()) { }
+
+        // A copy takes the words and leaves the element view behind
+        PackedCoefficients(const PackedCoefficients &rhs) : _ctx(rhs._ctx), _r(rhs.words()) { }
+
+        PackedCoefficients(PackedCoefficients &&) = default;
+
+        PackedCoefficients &operator=(const PackedCoefficients &rhs) {
+            if (&rhs != this) {
+                _ctx = rhs._ctx;
+                _r = rhs.words();
+                this->dropView();
+            }
+            return *this;
+        }
+
+        PackedCoefficients &operator=(PackedCoefficients &&) = default;
+
+        explicit operator std::vector<Felem>() const {
+            return std::vector<Felem>(this->begin(), this->end());
+        }
+
+        size_type size() const { return _view ? _e.size() : _r.size() / this->width(); }
+
+        bool empty() const { return this->size() == 0; }
+
+        void reserve(size_type n) { _view ? _e.reserve(n) : _r.reserve(n * this->width()); }
+
+        const_reference operator[](size_type i) const {
+            return _view ? _e[i] : Packing::read(_ctx, _r.data() + i * this->width());
+        }
+
+        reference operator[](size_type i) { return this->elements()[i]; }
+
+        const_reference back() const { return (*this)[this->size() - 1]; }
+
+        reference back() { return this->elements().back(); }
+
+        void push_back(const Felem &e) {
+            if (_ctx == nullptr)
+                _ctx = Packing::context(e);
+#ifndef ALCP_NO_CHECKS
+            else if (_ctx != Packing::context(e))
+                throw ENotCompatible("Not all the elements in the array are in the same ring.");
+#endif
+            if (_view)
+                _e.push_back(e);
+            else {
+                _r.resize(_r.size() + this->width());
+                Packing::write(_r.data() + _r.size() - this->width(), e);
+            }
+        }
+
+        void pop_back() { _view ? _e.pop_back() : _r.resize(_r.size() - this->width()); }
+
+        void resize(size_type n) {
+            if (_ctx != nullptr)
+                this->resize(n, Packing::zero(_ctx));
+            else
+                _r.resize(n * this->width(), Word(0));
+        }
+
+        void resize(size_type n, const Felem &value) {
+            if (_ctx == nullptr)
+                _ctx = Packing::context(value);
+            if (_view) {
+                _e.resize(n, value);
+                return;
+            }
+            const std::size_t old = this->size(), w = this->width();
+            _r.resize(n * w);
+            for (std::size_t i = old; i < n; ++i)
+                Packing::write(_r.data() + i * w, value);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            if (_view)
+                _e.erase(_e.begin() + first._i, _e.begin() + last._i);
+            else
+                _r.erase(_r.begin() + first._i * this->width(), _r.begin() + last._i * this->width());
+            return iterator(this, first._i);
+        }
+
+        iterator begin() { return iterator(this, 0); }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+
+        iterator end() { return iterator(this, this->size()); }
+
+        const_iterator end() const { return const_iterator(this, this->size()); }
+
+        const_iterator cbegin() const { return this->begin(); }
+
+        const_iterator cend() const { return this->end(); }
+
+        // Raw words, width() per coefficient
+        Word *data() {
+            this->words();
+            this->dropView();
+            return _r.data();
+        }
+
+        const Word *data() const { return this->words().data(); }
+
+        const Context *context() const { return _ctx; }
+
+        std::size_t width() const { return Packing::width(_ctx); }
+
+        friend bool operator==(const PackedCoefficients &lhs, const PackedCoefficients &rhs) {
+            return lhs.words() == rhs.words() && (lhs.empty() || lhs._ctx == rhs._ctx);
+        }
+
+        friend bool operator!=(const PackedCoefficients &lhs, const PackedCoefficients &rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        // The coefficients as elements. From here on they are stored in _e
+        std::vector<Felem> &elements() {
+            if (!_view && _ctx != nullptr) {
+                const std::size_t n = this->size(), w = this->width();
+                _e.clear();
+                _e.reserve(n);
+                for (std::size_t i = 0; i < n; ++i)
+                    _e.push_back(Packing::read(_ctx, _r.data() + i * w));
+                _view = true;
+            }
+            return _e;
+        }
+
+        // The words, copied from the element view if there is one
+        const std::vector<Word> &words() const {
+            if (_view) {
+                const std::size_t w = this->width();
+                _r.resize(_e.size() * w);
+                for (std::size_t i = 0; i < _e.size(); ++i) {
+#ifndef ALCP_NO_CHECKS
+                    if (Packing::context(_e[i]) != _ctx)
+                        throw ENotCompatible("Not all the elements in the array are in the same ring.");
+#endif
+                    Packing::write(_r.data() + i * w, _e[i]);
+                }
+            }
+            return _r;
+        }
+
+        void dropView() {
+            _view = false;
+            _e.clear();
+        }
+
+        const Context *_ctx = nullptr;
+        // Only up to date when there is no view
+        mutable std::vector<Word> _r;
+        std::vector<Felem> _e;
+        bool _view = false;
+    };
+}
+
+#endif // __PACKED_COEFFICIENTS_HPP
@@ -2,26 +2,101 @@
 #define __POL_RING_HPP
 
 #include <vector>
-#include <algorithm>        // find_if, count_if
-#include <utility>          // pair, make_pair
-#include <functional>       // not_equal_to
+#include <algorithm>        // count_if, min
+#include <utility>          // pair, make_pair, forward, declval
+#include <type_traits>      // integral_constant, true_type, false_type
 #include <string>           // to_string
 
 #include "types.hpp"
 #include "exceptions.hpp"
+#include "accumulator.hpp"
+#include "karatsuba.hpp"
+#include "preparedMultiplier.hpp"
 
 namespace alcp {
+    // Exact division by a fixed element d. Over a field d^{-1} is computed
+    //  just once and then every division is a multiplication by it
+    template<class Felem, bool = is_integral<Felem>::value, class = void>
+    class FixedDivisor {
+    public:
+        explicit FixedDivisor(const Felem &d) : _dInv(d.inv()) { }
+
+        Felem divide(const Felem &a) const { return a * _dInv; }
+
+    private:
+        Felem _dInv;
+    };
+
+    // d^{-1} is only prepared where that costs O(1), i.e. with Shoup's
+    //  multiplication. The PreparedMultiplier of Fqelem builds an m x m
+    //  matrix, more than the few coefficients of most divisions pay for
+    template<class Felem>
+    class FixedDivisor<Felem, false, decltype(static_cast<void>(shoupConstantMod(
+            std::declval<const typename Felem::Int &>(), std::declval<const typename Felem::ModulusType &>())))> {
+    public:
+        explicit FixedDivisor(const Felem &d) : _dInv(d.inv()) { }
+
+        Felem divide(const Felem &a) const { return _dInv.mul(a); }
+
+    private:
+        PreparedMultiplier<Felem> _dInv;
+    };
+
+    // Over Z it is just an integer division
+    template<class Felem>
+    class FixedDivisor<Felem, true, void> {
+    public:
+        explicit FixedDivisor(const Felem &d) : _d(d) { }
+
+        Felem divide(const Felem &a) const { return a / _d; }
+
+    private:
+        Felem _d;
+    };
+
+    // Container of the coefficients of a polynomial over Felem. It may be
+    //  specialized by any type with the interface of std::vector<Felem>
+    template<class Felem>
+    struct CoefficientStorage {
+        using type = std::vector<Felem>;
+    };
+
+    // Products in the ring FxelemBase use Karatsuba when both factors have at
+    //  least this number of coefficients. It is specialized by every ring with
+    //  the values that benchmarks/karatsubaTuning.cpp measures
+    template<template <class> class FxelemBase>
+    struct KaratsubaThreshold {
+        static constexpr std::size_t value = 32;
+    };
+
+    namespace newton {
+        // Threshold of div2 for the classical division at every size
+        constexpr std::size_t none = static_cast<std::size_t>(-1);
+    }
+
+    // Divisions over a field where both the quotient and the divisor have at
+    //  least this number of coefficients use Newton iteration. The default is
+    //  measured with Fpxelem when its products need three NTTs and the CRT,
+    //  where the crossover is between 2048 and 4096. The rings whose products
+    //  are cheaper compared to their long division lower it
+    template<template <class> class FxelemBase>
+    struct NewtonDivisionThreshold {
+        static constexpr std::size_t value = 2048;
+    };
+
     template<template <class> class FxelemBase , class Felem, class Integer>
     class PolynomialRing {
     static_assert(is_integral<Integer>::value, "Type is not a supported integer.");
     private:
         using Fxelem = FxelemBase<Integer>;
+    protected:
+        using Storage = typename CoefficientStorage<Felem>::type;
     public:
         using Int = Integer;
 
         // Iterator utilities
-        using iterator = typename std::vector<Felem>::iterator;
-        using const_iterator = typename std::vector<Felem>::const_iterator;
+        using iterator = typename Storage::iterator;
+        using const_iterator = typename Storage::const_iterator;
 
         // Variable used to print the polynomial by default
         constexpr static char var = 'x';
@@ -31,14 +106,14 @@ namespace alcp {
         // Copy immersion from the base ring
         template<class Felem_t,
                 class = std::enable_if_t<std::is_constructible<Felem, Felem_t>::value>>
-        PolynomialRing(const Felem_t &e) : _v(std::vector<Felem>({e})) { }
+        PolynomialRing(const Felem_t &e) : _v(1, Felem(e)) { }
 
         // Move immersion from base ring
         template<class Felem_t,
                 class = std::enable_if_t<std::is_constructible<Felem, Felem_t>::value>>
-        PolynomialRing(Felem_t &&e) : _v(std::vector<Felem>({std::move(e)})) { }
+        PolynomialRing(Felem_t &&e) : _v(1, Felem(std::forward<Felem_t>(e))) { }
 
-        PolynomialRing(const std::vector<Felem> &v) : _v(v) {
+        PolynomialRing(const std::vector<Felem> &v) : _v(v.begin(), v.end()) {
             // Remove trailing zeros
             this->removeTrailingZeros();
 #ifndef ALCP_NO_CHECKS
@@ -130,7 +205,7 @@ namespace alcp {
                             "Assignation failed. The elements are not in the same ring.");
 #endif
 
-            _v = std::vector<Felem>(rhs);
+            _v = PolynomialRing(rhs)._v;
             return static_cast<Fxelem&>(*this);
         }
 
@@ -143,11 +218,11 @@ namespace alcp {
                 checkInSameField(PolynomialRing(rhs),
                             "Assignation failed. The elements are not in the same ring.");
 #endif
-            _v = std::vector<Felem>(std::move(rhs));
+            _v = PolynomialRing(std::forward<Felem_t>(rhs))._v;
             return static_cast<Fxelem&>(*this);
         }
 
-        explicit operator std::vector<Felem>() const { return _v; }
+        explicit operator std::vector<Felem>() const { return std::vector<Felem>(_v.begin(), _v.end()); }
 
         friend inline bool operator==(const Fxelem &lhs, const Fxelem &rhs) {
             return lhs._v == rhs._v;
@@ -229,61 +304,59 @@ namespace alcp {
             checkInSameField(PolynomialRing(rhs),
                         "Polynomials not in the same ring. Error when multiplying the polynomials.");
 #endif
-            std::vector<Felem> ret(rhs._v.size() + _v.size() - 1, getZero(this->lc()));
-            for (size_t i = 0; i < _v.size(); ++i)
-                for (size_t j = 0; j < rhs._v.size(); ++j) {
-                    ret[i + j] += _v[i] * rhs._v[j];
-                }
-            _v = ret;
+            const std::vector<Felem> ret = product(*this, rhs, KaratsubaThreshold<FxelemBase>::value);
+            _v = Storage(ret.begin(), ret.end());
             this->removeTrailingZeros();
             return static_cast<Fxelem &>(*this);
         }
 
+        // A square multiplies the copy by itself, so that the rings that
+        //  detect squares by identity in *= see one
         friend inline Fxelem operator*(const Fxelem &lhs, const Fxelem &rhs) {
-            return Fxelem(lhs) *= rhs;
+            Fxelem ret(lhs);
+            if (&lhs == &rhs)
+                return ret *= ret;
+            return ret *= rhs;
+        }
+
+        // Product with the given Karatsuba threshold (karatsuba::none for the
+        //  schoolbook product). Used to tune KaratsubaThreshold
+        static Fxelem mul(const Fxelem &lhs, const Fxelem &rhs, std::size_t threshold) {
+#ifndef ALCP_NO_CHECKS
+            lhs.checkInSameField(PolynomialRing(rhs),
+                        "Polynomials not in the same ring. Error when multiplying the polynomials.");
+#endif
+            return Fxelem(product(lhs, rhs, threshold));
         }
 
-        // Implements long polynomial division
-        // Return quotient and reminder in first and second respectively
+        // Quotient and remainder in first and second respectively. Over a field,
+        //  long divisions use Newton iteration
         std::pair<Fxelem, Fxelem> div2(const Fxelem &divisor) const {
+            return div2(static_cast<const Fxelem &>(*this), divisor, NewtonDivisionThreshold<FxelemBase>::value);
+        }
+
+        // Division with the given Newton threshold (newton::none for the
+        //  classical division). Used to tune NewtonDivisionThreshold
+        static std::pair<Fxelem, Fxelem> div2(const Fxelem &dividend, const Fxelem &divisor, std::size_t threshold) {
 #ifndef ALCP_NO_CHECKS
-            checkInSameField(PolynomialRing(divisor),
+            dividend.checkInSameField(PolynomialRing(divisor),
                         "Polynomials not in the same ring. Error when dividing the polynomials.");
 #endif
 
             if (divisor == 0)
                 throw EOperationUnsupported("Error. Cannot divide by the polynomial 0");
-            if (this->deg() < divisor.deg())
-                return std::make_pair(Fxelem(getZero(this->lc())), static_cast<const Fxelem &>(*this));
-
-            if (divisor.deg() == 0) {
-                Fxelem quot(static_cast<const Fxelem &>(*this));
-                Fxelem rem(static_cast<const Fxelem &>(*this));
-                std::for_each(quot.begin(),
-                              quot.end(),
-                              [lc = divisor.lc()](Felem &elem){elem /= lc;});
-
-                return std::make_pair(quot, Fxelem(getZero(this->lc())));
-            }
-
-            Fxelem quot(getZero(this->lc()));
-            Fxelem rem(static_cast<const Fxelem &>(*this));
-
-            while (rem.deg() >= divisor.deg()) {
-                std::vector<Felem> paddingZeros(rem.deg() - divisor.deg(), getZero(this->lc()));
-
-                paddingZeros.push_back(rem.lc() / divisor.lc());
-                Fxelem monDiv(paddingZeros);
-                quot += monDiv;
-                rem -= monDiv * divisor;
-            }
-            rem.removeTrailingZeros();
-
-            return std::make_pair(quot, rem);
+            if (dividend.deg() < divisor.deg())
+                return std::make_pair(Fxelem(getZero(dividend.lc())), dividend);
+
+            const std::size_t k = dividend.deg() - divisor.deg() + 1;
+            if (std::min(k, divisor.deg()) >= threshold)
+                return newtonDivision(dividend, divisor, threshold,
+                                      std::integral_constant<bool, !is_integral<Felem>::value>());
+            return classicalDivision(dividend, divisor);
         }
 
         Fxelem &operator/=(const Fxelem &rhs) {
-            *this = this->div2(rhs).first;
+            *this = static_cast<const Fxelem &>(*this).div2(rhs).first;
             return static_cast<Fxelem &>(*this);
         }
 
@@ -292,7 +365,7 @@ namespace alcp {
         }
 
         Fxelem &operator%=(const Fxelem &rhs) {
-            *this = this->div2(rhs).second;
+            *this = static_cast<const Fxelem &>(*this).div2(rhs).second;
             return static_cast<Fxelem &>(*this);
         }
 
@@ -300,14 +373,14 @@ namespace alcp {
             return Fxelem(static_cast<const Fxelem &>(*this)) %= rhs;
         }
 
-        const Felem &operator[](size_t i) const { return _v[i]; }
+        typename Storage::const_reference operator[](size_t i) const { return _v[i]; }
 
-        Felem &operator[](size_t i) { return _v[i]; }
+        typename Storage::reference operator[](size_t i) { return _v[i]; }
 
         Fxelem derivative() const {
             if (this->deg() == 0)
                 return Fxelem(getZero(this->lc()));
-            std::vector<Felem> v(_v);
+            std::vector<Felem> v(_v.begin(), _v.end());
             for (size_t i = 1; i < v.size(); ++i)
                 v[i - 1] = v[i] * i;
             v.pop_back();
@@ -390,24 +463,175 @@ namespace alcp {
         }
 
     protected:
-        std::vector<Felem> _v;
+        Storage _v;
+
+        void removeTrailingZeros() {
+            Felem zero = getZero(this->lc());
+            // Read through a const reference, so that it does not ask the
+            //  container for references to its coefficients
+            const Storage &v = _v;
+            std::size_t n = v.size();
+            while (n > 0 && v[n - 1] == zero)
+                --n;
+            // The polynomial equal to zero keeps its constant coefficient
+            if (n == 0 && !_v.empty())
+                n = 1;
+            _v.erase(_v.begin() + n, _v.end());
+            if (_v.size() == 0)
+                _v.push_back(std::move(zero));
+        }
 
     private:
 
         template <template <class> class, class, class>
         friend class PolynomialRing;
 
-        void removeTrailingZeros() {
-            Felem zero = getZero(this->lc());
-            _v.erase(
-                    std::find_if(
-                            _v.rbegin(),
-                            _v.rend(),
-                            std::bind1st(std::not_equal_to<Felem>(), zero)).base(),
-                    _v.end());
-            // In case it was the polynomial equal to zero
-            if (_v.size() == 0)
-                _v.push_back(std::move(zero));
+        // Coefficients of lhs*rhs. Below the threshold every coefficient
+        //  ret[k] = sum_{i+j=k} lhs[i]*rhs[j] is computed with one accumulator, so
+        //  it is reduced just once
+        static std::vector<Felem> product(const PolynomialRing &lhs, const PolynomialRing &rhs,
+                                          std::size_t threshold) {
+            const std::size_t n = lhs._v.size(), m = rhs._v.size();
+            const Felem zero = getZero(lhs.lc());
+            std::vector<Felem> ret(n + m - 1, zero);
+            if (std::min(n, m) < threshold)
+                karatsuba::schoolbook(ret.data(), lhs._v, n, rhs._v, m, zero);
+            else {
+                const std::vector<Felem> a(lhs._v.begin(), lhs._v.end()), b(rhs._v.begin(), rhs._v.end());
+                std::vector<Felem> scratch(karatsuba::scratchSize(n, m, threshold), zero);
+                karatsuba::mul(ret.data(), a.data(), n, b.data(), m, scratch.data(), threshold, zero);
+            }
+            return ret;
+        }
+
+        /**
+         * Long division
+         *
+         * Description:
+         *  Every coefficient of the quotient, from the highest one, and of the
+         *   remainder is a dot product: with d = deg(b) and a = q b + r,
+         *   q_i = (a_{i+d} - sum_{j>=1} q_{i+j} b_{d-j}) / lc(b) and
+         *   r_i = a_i - sum_j q_j b_{i-j}. Each of them is computed with one
+         *   Accumulator, so the only allocations are the ones of the result.
+         *  Over Z the division by lc(b) is the integer one. If one of them is
+         *   not exact then b does not divide a, and the remainder is
+         *   a - q b over all the degrees, so it is never 0.
+         *
+         * Complexity:
+         *  O(deg(q) deg(b)) operations in the base ring
+         */
+        static std::pair<Fxelem, Fxelem> classicalDivision(const PolynomialRing &a, const PolynomialRing &b) {
+            const std::size_t d = b.deg(), k = a.deg() - d + 1;
+            const Felem zero = getZero(a.lc());
+            const FixedDivisor<Felem> lc(b.lc());
+            std::vector<Felem> q(k, zero), r(std::max<std::size_t>(d, 1), zero);
+            bool exact = true;
+            for (std::size_t i = k; i-- > 0;) {
+                Accumulator<Felem> acc(a._v[i + d]);
+                for (std::size_t j = 1; j <= std::min(d, k - 1 - i); ++j)
+                    acc.subProduct(q[i + j], b._v[d - j]);
+                const Felem c = acc.get();
+                q[i] = lc.divide(c);
+                if (is_integral<Felem>::value && q[i] * b.lc() != c)
+                    exact = false;
+            }
+            if (!exact) {
+                const Fxelem quot(q);
+                return std::make_pair(quot, static_cast<const Fxelem &>(a) - quot * static_cast<const Fxelem &>(b));
+            }
+            for (std::size_t i = 0; i < d; ++i) {
+                Accumulator<Felem> acc(a._v[i]);
+                for (std::size_t j = 0; j <= std::min(i, k - 1); ++j)
+                    acc.subProduct(q[j], b._v[i - j]);
+                r[i] = acc.get();
+            }
+            return std::make_pair(Fxelem(q), Fxelem(r));
+        }
+
+        /**
+         * Division with Newton iteration
+         *
+         * Description:
+         *  With n = deg(a), d = deg(b) and k = n - d + 1, the reversed
+         *   polynomials rev_j(f) = x^{j-1} f(1/x) satisfy
+         *   rev_{n+1}(a) = rev_k(q) rev_{d+1}(b) (mod x^k), as deg(r) < d.
+         *   The inverse of rev_{d+1}(b), whose constant term is lc(b), is
+         *   computed modulo x^k, so rev_k(q) is its product with rev_{n+1}(a)
+         *   and r = a - q b, where only the low d coefficients of q b are
+         *   needed.
+         *  The inverse is computed with dot products up to the precision
+         *   k/2^s below threshold, as in classicalDivision, and then with
+         *   Newton iteration. Every step is a product of Fxelem, so it uses
+         *   the fastest product of the ring (Karatsuba, the NTT or Kronecker
+         *   substitution).
+         *
+         * Theoretical background:
+         *  If g f = 1 (mod x^l) then g' = g + g (1 - f g) satisfies
+         *   g' f = 1 (mod x^{2l}), so the precision doubles in every step.
+         *
+         * Complexity:
+         *  O(M(k) + M(max(k, d))), where M(n) is the cost of a product of
+         *   polynomials of degree n
+         */
+        static std::pair<Fxelem, Fxelem> newtonDivision(const PolynomialRing &a, const PolynomialRing &b,
+                                                        std::size_t threshold, std::true_type) {
+            const std::size_t d = b.deg(), k = a.deg() - d + 1;
+            const Fxelem rb = b.reversed(d + 1, k);
+            std::vector<std::size_t> precisions{k};
+            while (precisions.back() >= std::max<std::size_t>(threshold, 2))
+                precisions.push_back((precisions.back() + 1) / 2);
+            Fxelem g = rb.inverse(precisions.back());
+            for (std::size_t i = precisions.size() - 1; i-- > 0;) {
+                const std::size_t l = precisions[i];
+                const Fxelem e = (rb.coefficients(0, l) * g).coefficients(0, l);
+                g += (g * (Fxelem(getOne(b.lc())) - e)).coefficients(0, l);
+            }
+            const Fxelem q = (a.reversed(a.deg() + 1, k) * g).reversed(k, k);
+            const Fxelem r = a.coefficients(0, d) - (q * static_cast<const Fxelem &>(b)).coefficients(0, d);
+            return std::make_pair(q, r);
+        }
+
+        // Over Z lc(b) need not be a unit
+        static std::pair<Fxelem, Fxelem> newtonDivision(const PolynomialRing &a, const PolynomialRing &b,
+                                                        std::size_t, std::false_type) {
+            return classicalDivision(a, b);
+        }
+
+        // The inverse modulo x^l of a polynomial with a_0 invertible, where
+        //  g_i = -(sum_{j>=1} a_j g_{i-j}) / a_0
+        Fxelem inverse(std::size_t l) const {
+            const Felem zero = getZero(this->lc());
+            const FixedDivisor<Felem> a0(_v[0]);
+            std::vector<Felem> g(l, zero);
+            g[0] = a0.divide(getOne(this->lc()));
+            for (std::size_t i = 1; i < l; ++i) {
+                Accumulator<Felem> acc(zero);
+                for (std::size_t j = 1; j <= std::min(i, this->deg()); ++j)
+                    acc.subProduct(_v[j], g[i - j]);
+                g[i] = a0.divide(acc.get());
+            }
+            return Fxelem(g);
+        }
+
+        // sum_{i<count} a_{first+i} x^i
+        Fxelem coefficients(std::size_t first, std::size_t count) const {
+            const Felem zero = getZero(this->lc());
+            std::vector<Felem> ret(std::min(count, _v.size() > first ? _v.size() - first : 0), zero);
+            for (std::size_t i = 0; i < ret.size(); ++i)
+                ret[i] = _v[first + i];
+            if (ret.empty())
+                ret.push_back(zero);
+            return Fxelem(ret);
+        }
+
+        // rev_size(a) mod x^count, i.e. sum_{i<count} a_{size-1-i} x^i
+        Fxelem reversed(std::size_t size, std::size_t count) const {
+            const Felem zero = getZero(this->lc());
+            std::vector<Felem> ret(std::min(size, count), zero);
+            for (std::size_t i = 0; i < ret.size(); ++i)
+                if (size - 1 - i < _v.size())
+                    ret[i] = _v[size - 1 - i];
+            return Fxelem(ret);
         }
 
 #ifndef ALCP_NO_CHECKS
@@ -0,0 +1,133 @@
+#ifndef __PREPARED_MULTIPLIER_HPP
+#define __PREPARED_MULTIPLIER_HPP
+
+#include <cstdint>      // std::uint64_t
+#include <type_traits>  // std::enable_if_t
+#include <utility>      // std::declval
+#include <vector>
+
+#include "modArith.hpp"     // shoupConstantMod, shoupMulMod
+#include "accumulator.hpp"
+
+namespace alcp {
+    /**
+     * Multiplication by a fixed element
+     *
+     * Description:
+     *  Multiplies many elements by the same w. Whatever depends only on w is
+     *   computed once, when the multiplier is built.
+     *  Use it as
+     *   PreparedMultiplier<Felem> byW(w);
+     *   Felem aw = byW.mul(a);
+     *  The generic version just uses the product of Felem.
+     */
+    template<class Felem, class = void>
+    class PreparedMultiplier {
+    public:
+        explicit PreparedMultiplier(const Felem &w) : _w(w) { }
+
+        Felem mul(const Felem &a) const { return a * _w; }
+
+        const Felem &get() const { return _w; }
+
+    private:
+        Felem _w;
+    };
+
+    /**
+     * Shoup's multiplication for elements of Z/pZ stored in a machine word
+     *
+     * Description:
+     *  Stores w together with floor(w*2^64/p), so every product costs two
+     *   integer multiplications and no division (see shoupMul).
+     *  It is selected for every Felem whose modulus supports shoupMulMod,
+     *   i.e. Fpelem over a built-in signed integer and StaticFpelem.
+     */
+    template<class Felem>
+    class PreparedMultiplier<Felem, decltype(static_cast<void>(shoupConstantMod(
+            std::declval<const typename Felem::Int &>(), std::declval<const typename Felem::ModulusType &>())))> {
+    public:
+        explicit PreparedMultiplier(const Felem &w) : _w(w), _wShoup(shoupConstantMod(w._num, w.mod())) { }
+
+        Felem mul(const Felem &a) const {
+            Felem ret(_w);
+            ret._num = shoupMulMod(a._num, _w._num, _wShoup, _w.mod());
+            return ret;
+        }
+
+        const Felem &get() const { return _w; }
+
+    private:
+        Felem _w;
+        std::uint64_t _wShoup;
+    };
+
+    /**
+     * Fixed matrix over a field
+     *
+     * Description:
+     *  Every entry is stored as a PreparedMultiplier, so it pays off when the
+     *   same matrix multiplies many vectors. The products of each entry of
+     *   the result are added with an Accumulator.
+     *
+     * Complexity:
+     *  O(rows*cols) multiplications per product
+     */
+    template<class Felem>
+    class PreparedMatrix {
+    public:
+        // m is given by rows and it is not empty
+        explicit PreparedMatrix(const std::vector<std::vector<Felem>> &m) : _zero(getZero(m[0][0])) {
+            // Stored by columns, so that every entry of v*M is a contiguous dot product
+            _t.resize(m[0].size());
+            for (std::size_t i = 0; i < _t.size(); ++i) {
+                _t[i].reserve(m.size());
+                for (std::size_t j = 0; j < m.size(); ++j)
+                    _t[i].emplace_back(m[j][i]);
+            }
+        }
+
+        // v*M, with v a row vector of size rows
+        std::vector<Felem> mulLeft(const std::vector<Felem> &v) const {
+            std::vector<Felem> ret;
+            ret.reserve(_t.size());
+            this->mulLeft([&v](std::size_t j) { return v[j]; },
+                          [&ret](std::size_t, const Felem &e) { ret.push_back(e); });
+            return ret;
+        }
+
+        // v*M, where v(j) is the j-th entry of v, calling out(i, e) with every
+        //  entry e of the result. Lets other containers be read and written in
+        //  place
+        template<class Entry, class Out>
+        void mulLeft(const Entry &v, const Out &out) const {
+            for (std::size_t i = 0; i < _t.size(); ++i) {
+                Accumulator<Felem> acc(_zero);
+                for (std::size_t j = 0; j < _t[i].size(); ++j)
+                    acc.add(_t[i][j].mul(v(j)));
+                out(i, acc.get());
+            }
+        }
+
+    private:
+        Felem _zero;
+        std::vector<std::vector<PreparedMultiplier<Felem>>> _t;
+    };
+
+    // c*pol
+    template<class Fxelem>
+    Fxelem scale(Fxelem pol, const PreparedMultiplier<typename Fxelem::Felem> &c) {
+        if (c.get() == 0)
+            return getZero(pol);
+        for (std::size_t i = 0; i <= pol.deg(); ++i)
+            pol[i] = c.mul(pol[i]);
+        return pol;
+    }
+
+    template<class Fxelem>
+    Fxelem scale(Fxelem pol, const typename Fxelem::Felem &c) {
+        return scale(std::move(pol), PreparedMultiplier<typename Fxelem::Felem>(c));
+    }
+}
+
+#endif // __PREPARED_MULTIPLIER_HPP
@@ -5,18 +5,69 @@
 #include <memory>           // std::unique_ptr,  std::make_unique
 #include <string>           // std::to_string
 #include <type_traits>      // std::enable_if, std::is_integral
-#include <utility>          // std::move
+#include <utility>          // std::move, std::declval
 
 #include "generalPurpose.hpp" // ExtendedEuclideanAlgorithm (eea)
+#include "modArith.hpp"       // addMod, mulMod...
 #include "exceptions.hpp"
 
 namespace alcp {
-    template<template <class> class FelemBase, class Quotient, class Integer>
-    class QuotientRing {
+    // Stores the modulus of an element. When the modulus is known at compile
+    //  time (i.e. it is an empty type) it takes no space in the element
+    template<class Modulus, bool = std::is_empty<Modulus>::value>
+    class ModulusStorage {
+    protected:
+        ModulusStorage() = default;
+        ModulusStorage(const Modulus &mod) : _mod(mod) { }
+        ModulusStorage(Modulus &&mod) : _mod(std::move(mod)) { }
+
+        const Modulus &mod() const { return _mod; }
+
+        void setMod(const Modulus &mod) { _mod = mod; }
+
+        void setMod(Modulus &&mod) { _mod = std::move(mod); }
+
+        // Relies in the fact that it is not possible to quotient by the ideal generated by 0
+        bool hasMod() const { return _mod != Modulus(); }
+
+    private:
+        Modulus _mod = Modulus();
+    };
+
+    template<class Modulus>
+    class ModulusStorage<Modulus, true> {
+    protected:
+        ModulusStorage() = default;
+        ModulusStorage(const Modulus &) { }
+
+        Modulus mod() const { return Modulus(); }
+
+        void setMod(const Modulus &) { }
+
+        bool hasMod() const { return true; }
+    };
+
+    // Converts the modulus of an element of another QuotientRing<FelemBase, Quot, ...>
+    //  to Modulus. By default it goes through the generator of the ideal. Moduli
+    //  that point to a context have no such conversion unless they specialise it
+    template<class Modulus, class Quotient>
+    struct ModulusConversion {
+        template<class Quot, class Mod>
+        static auto convert(const Mod &mod) -> decltype(Modulus(static_cast<Quotient>(static_cast<Quot>(mod)))) {
+            return Modulus(static_cast<Quotient>(static_cast<Quot>(mod)));
+        }
+    };
+
+    // Modulus is the type used to store the generator of the ideal. It defaults
+    //  to Quotient, but it may carry precomputed constants to reduce faster
+    template<template <class> class FelemBase, class Quotient, class Integer, class Modulus = Quotient>
+    class QuotientRing : protected ModulusStorage<Modulus> {
+    using MBase = ModulusStorage<Modulus>;
     static_assert(is_integral<Integer>::value, "Type is not a supported integer.");
     public:
         using Felem = FelemBase<Integer>;
         using Int = Integer;
+        using ModulusType = Modulus;
         QuotientRing() = default;
 
         QuotientRing(const QuotientRing &) = default;
@@ -24,15 +75,21 @@ namespace alcp {
         // Necesario Integer porque si hacemos class Felem, en vez de class template,
         //  no podemos hacer const QuotientRing<Felem,Quot> con Quot un template dado que
         //  los templates serian diferentes
-        template<class Int, class Quot,
-                class = std::enable_if_t<is_integral<Int>::value>>
-        QuotientRing(const QuotientRing<FelemBase, Quot, Int> &rhs) :_mod(rhs._mod), _num(rhs._num){ }
+        template<class Int, class Quot, class Mod,
+                class = std::enable_if_t<is_integral<Int>::value>,
+                class = decltype(ModulusConversion<Modulus, Quotient>::template convert<Quot>(std::declval<const Mod &>()))>
+        QuotientRing(const QuotientRing<FelemBase, Quot, Int, Mod> &rhs) :
+                MBase(ModulusConversion<Modulus, Quotient>::template convert<Quot>(rhs.mod())),
+                _num(static_cast<Quotient>(rhs._num)){ }
 
         QuotientRing(QuotientRing &&) = default;
 
-        template<class Int, class Quot,
-                class = std::enable_if_t<is_integral<Int>::value>>
-        QuotientRing(QuotientRing<FelemBase, Quot, Int> &&rhs) : _mod(std::move(rhs._mod)), _num(std::move(rhs._num)){ }
+        template<class Int, class Quot, class Mod,
+                class = std::enable_if_t<is_integral<Int>::value>,
+                class = decltype(ModulusConversion<Modulus, Quotient>::template convert<Quot>(std::declval<const Mod &>()))>
+        QuotientRing(QuotientRing<FelemBase, Quot, Int, Mod> &&rhs) :
+                MBase(ModulusConversion<Modulus, Quotient>::template convert<Quot>(rhs.mod())),
+                _num(static_cast<Quotient>(std::move(rhs._num))){ }
 
         // Copy assignment
 #ifndef ALCP_NO_CHECKS
@@ -40,7 +97,7 @@ namespace alcp {
             if (&rhs != this && rhs.init()){
                 if (this->init())
                     checkInSameField(rhs, "The elements are not in the same ring.");
-                _mod = rhs._mod;
+                this->setMod(rhs.mod());
                 _num = rhs._num;
             }
             return *this;
@@ -50,9 +107,9 @@ namespace alcp {
 #endif
 
         // Duplicated code for generalized copy... :/
-        template<class Int, class Quot,
+        template<class Int, class Quot, class Mod,
                 class = std::enable_if_t<is_integral<Int>::value>>
-        QuotientRing &operator=(const QuotientRing<FelemBase, Quot, Int> &rhs){
+        QuotientRing &operator=(const QuotientRing<FelemBase, Quot, Int, Mod> &rhs){
             return *this = QuotientRing(rhs);
         }
 
@@ -62,7 +119,7 @@ namespace alcp {
             if (&rhs != this && rhs.init()) {
                 if (this->init())
                     checkInSameField(rhs, "The elements are not in the same ring.");
-                _mod = std::move(rhs._mod);
+                this->setMod(rhs.mod());
                 _num = std::move(rhs._num);
             }
             return *this;
@@ -71,9 +128,9 @@ namespace alcp {
         QuotientRing &operator=(QuotientRing &&rhs) = default;
 #endif
 
-        template<class Int, class Quot,
+        template<class Int, class Quot, class Mod,
                 class = std::enable_if_t<is_integral<Int>::value>>
-        QuotientRing &operator=(QuotientRing<FelemBase, Quot, Int> &&rhs){
+        QuotientRing &operator=(QuotientRing<FelemBase, Quot, Int, Mod> &&rhs){
             return *this = QuotientRing(std::move(rhs));
         }
 
@@ -91,7 +148,7 @@ namespace alcp {
         explicit operator Quotient() const { return _num; }
 
         friend inline bool operator==(const Felem &lhs, const Felem &rhs){
-            return (lhs._num == rhs._num && lhs._mod == rhs._mod);
+            return (lhs._num == rhs._num && lhs.mod() == rhs.mod());
         }
 
         friend inline bool operator!=(const Felem &lhs, const Felem &rhs){
@@ -99,26 +156,26 @@ namespace alcp {
         }
 
         friend inline bool operator<(const Felem &lhs, const Felem &rhs){
-			return (lhs._num < rhs._num && lhs._mod == rhs._mod);
+			return (lhs._num < rhs._num && lhs.mod() == rhs.mod());
 		}
 
         friend inline bool operator<=(const Felem &lhs, const Felem &rhs){
-			return (lhs._num <= rhs._num && lhs._mod == rhs._mod);
+			return (lhs._num <= rhs._num && lhs.mod() == rhs.mod());
 		}
 
         friend inline bool operator>(const Felem &lhs, const Felem &rhs){
-			return (lhs._num > rhs._num && lhs._mod == rhs._mod);
+			return (lhs._num > rhs._num && lhs.mod() == rhs.mod());
 		}
 
 		friend inline bool operator>=(const Felem &lhs, const Felem &rhs){
-			return (lhs._num >= rhs._num && lhs._mod == rhs._mod);
+			return (lhs._num >= rhs._num && lhs.mod() == rhs.mod());
 		}
 
         Felem &operator+=(const Felem &rhs) {
 #ifndef ALCP_NO_CHECKS
             checkInSameField(rhs, "Addition or substraction error.");
 #endif
-            _num = (_num + rhs._num) % _mod;
+            _num = addMod(_num, rhs._num, this->mod());
             return static_cast<Felem &>(*this);
         }
 
@@ -127,11 +184,17 @@ namespace alcp {
         }
 
         Felem operator-() const {
-            return static_cast<const Felem*>(this)->getField().get(-_num);
+            Felem ret(static_cast<const Felem &>(*this));
+            ret._num = negMod(_num, this->mod());
+            return ret;
         }
 
         Felem &operator-=(const Felem &rhs) {
-            return (static_cast<Felem &>(*this) += (-rhs));
+#ifndef ALCP_NO_CHECKS
+            checkInSameField(rhs, "Addition or substraction error.");
+#endif
+            _num = subMod(_num, rhs._num, this->mod());
+            return static_cast<Felem &>(*this);
         }
 
         Felem operator-(const Felem &rhs) const {
@@ -142,7 +205,7 @@ namespace alcp {
 #ifndef ALCP_NO_CHECKS
             checkInSameField(rhs, "Multiplication or division error.");
 #endif
-            _num = (_num * rhs._num) % _mod;
+            _num = mulMod(_num, rhs._num, this->mod());
             return static_cast<Felem &>(*this);
         }
 
@@ -154,10 +217,9 @@ namespace alcp {
         Felem inv() const {
             if (_num == 0)
                 throw EOperationUnsupported("Error. Zero has no inverse.");
-            Quotient res, aux;
-            eea(_num, _mod, res, aux);
-
-            return static_cast<const Felem*>(this)->getField().get(res);
+            Felem ret(static_cast<const Felem &>(*this));
+            ret._num = invMod(_num, this->mod());
+            return ret;
         }
 
         Felem &operator/=(const Felem &rhs) {
@@ -246,28 +308,32 @@ namespace alcp {
             return lhs.getField() == rhs.getField();
         }
 
-        friend Felem getZero(const Felem &e) { return e.getField().get(0); }
+        friend Felem getZero(const Felem &e) { return e.getField().zero(); }
 
-        friend Felem getOne(const Felem &e) { return e.getField().get(1); }
+        friend Felem getOne(const Felem &e) { return e.getField().one(); }
 
     protected:
-        QuotientRing(const Quotient& num, const Quotient& mod) : _num(num), _mod(mod){ }
-        QuotientRing(Quotient&& num, Quotient&& mod) : _num(std::move(num)), _mod(std::move(mod)){ }
+        QuotientRing(const Quotient& num, const Modulus& mod) : MBase(mod), _num(num){ }
+        QuotientRing(Quotient&& num, Modulus&& mod) : MBase(std::move(mod)), _num(std::move(num)){ }
 
         Quotient _num;
-        Quotient _mod;
 
-        template <template <class> class, class, class>
+        template <template <class> class, class, class, class>
             friend class QuotientRing;
 
         // It shows the init function
         template <template <class> class, class, class>
             friend class PolynomialRing;
+
+        template <class, class>
+            friend class Accumulator;
+
+        template <class, class>
+            friend class PreparedMultiplier;
     private:
 
 #ifndef ALCP_NO_CHECKS
-        // Relies in the fact that it is not possible to quotient by the ideal generated by 0
-        bool init() const { return _mod != Quotient(); }
+        bool init() const { return this->hasMod(); }
 
         void checkInSameField(const QuotientRing &rhs, std::string &&error) const {
             if (!compatible(static_cast<const Felem &>(*this),
@@ -0,0 +1,320 @@
+#include "simdKernels.hpp"
+
+#if !defined(ALCP_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALCP_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define ALCP_SIMD_X86 0
+#endif
+
+namespace alcp {
+    namespace simd {
+        namespace {
+            // Portable kernels. They are also used for the tails of the vectorized ones
+
+            inline std::uint64_t reduceOnce(std::uint64_t r, std::uint64_t p) {
+                return r >= p ? r - p : r;
+            }
+
+            // floor(w*2^32/p), as in shoupConstant but with 32-bit words
+            inline std::uint64_t shoupConstant32(std::uint64_t w, std::uint64_t p) {
+                return (w << 32) / p;
+            }
+
+            inline std::uint64_t shoupMul32(std::uint64_t a, std::uint64_t w, std::uint64_t wShoup, std::uint64_t p) {
+                return reduceOnce(a * w - ((a * wShoup) >> 32) * p, p);
+            }
+
+            // x^k (mod p)
+            std::uint64_t powMod32(std::uint64_t x, unsigned k, std::uint64_t p) {
+                std::uint64_t ret = 1 % p;
+                for (; k != 0; k /= 2) {
+                    if (k % 2 != 0)
+                        ret = ret * x % p;
+                    x = x * x % p;
+                }
+                return ret;
+            }
+
+            void addScalar(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = a[i] + b[i] >= p ? a[i] + b[i] - p : a[i] + b[i];
+            }
+
+            void subScalar(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = a[i] >= b[i] ? a[i] - b[i] : a[i] + (p - b[i]);
+            }
+
+            void negScalar(long long *r, const long long *a, std::size_t n, long long p) {
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = a[i] == 0 ? 0 : p - a[i];
+            }
+
+            void scaleScalar(long long *r, const long long *a, std::size_t n, long long w, long long p) {
+                const std::uint64_t wShoup = shoupConstant32(w, p);
+                for (std::size_t i = 0; i < n; ++i)
+                    r[i] = static_cast<long long>(shoupMul32(a[i], w, wShoup, p));
+            }
+
+            void axpyScalar(long long *y, const long long *x, std::size_t n, long long w, long long p) {
+                const std::uint64_t wShoup = shoupConstant32(w, p);
+                for (std::size_t i = 0; i < n; ++i)
+                    y[i] = static_cast<long long>(reduceOnce(y[i] + shoupMul32(x[i], w, wShoup, p), p));
+            }
+
+            long long hornerScalar(const long long *a, std::size_t n, long long x, long long p) {
+                const std::uint64_t xShoup = shoupConstant32(x, p);
+                std::uint64_t ret = 0;
+                for (std::size_t i = n; i-- > 0;)
+                    ret = reduceOnce(shoupMul32(ret, x, xShoup, p) + a[i], p);
+                return static_cast<long long>(ret);
+            }
+
+#if ALCP_SIMD_X86
+            // SSE4.1 kernels, 2 lanes
+
+            // r < 2p
+            __attribute__((target("sse4.1")))
+            inline __m128i reduceSse(__m128i r, __m128i p) {
+                return _mm_min_epu32(r, _mm_sub_epi64(r, p));
+            }
+
+            __attribute__((target("sse4.1")))
+            inline __m128i shoupMulSse(__m128i a, __m128i w, __m128i wShoup, __m128i p) {
+                __m128i q = _mm_srli_epi64(_mm_mul_epu32(a, wShoup), 32);
+                return reduceSse(_mm_sub_epi64(_mm_mul_epu32(a, w), _mm_mul_epu32(q, p)), p);
+            }
+
+            __attribute__((target("sse4.1")))
+            inline __m128i loadSse(const long long *a) {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+            }
+
+            __attribute__((target("sse4.1")))
+            inline void storeSse(long long *r, __m128i v) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(r), v);
+            }
+
+            __attribute__((target("sse4.1")))
+            void addSse(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+                const __m128i vp = _mm_set1_epi64x(p);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    storeSse(r + i, reduceSse(_mm_add_epi64(loadSse(a + i), loadSse(b + i)), vp));
+                addScalar(r + i, a + i, b + i, n - i, p);
+            }
+
+            __attribute__((target("sse4.1")))
+            void subSse(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+                const __m128i vp = _mm_set1_epi64x(p);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    __m128i d = _mm_sub_epi64(loadSse(a + i), loadSse(b + i));
+                    storeSse(r + i, _mm_min_epu32(d, _mm_add_epi64(d, vp)));
+                }
+                subScalar(r + i, a + i, b + i, n - i, p);
+            }
+
+            __attribute__((target("sse4.1")))
+            void negSse(long long *r, const long long *a, std::size_t n, long long p) {
+                const __m128i vp = _mm_set1_epi64x(p);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    storeSse(r + i, reduceSse(_mm_sub_epi64(vp, loadSse(a + i)), vp));
+                negScalar(r + i, a + i, n - i, p);
+            }
+
+            __attribute__((target("sse4.1")))
+            void scaleSse(long long *r, const long long *a, std::size_t n, long long w, long long p) {
+                const __m128i vp = _mm_set1_epi64x(p);
+                const __m128i vw = _mm_set1_epi64x(w);
+                const __m128i vwShoup = _mm_set1_epi64x(static_cast<long long>(shoupConstant32(w, p)));
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    storeSse(r + i, shoupMulSse(loadSse(a + i), vw, vwShoup, vp));
+                scaleScalar(r + i, a + i, n - i, w, p);
+            }
+
+            __attribute__((target("sse4.1")))
+            void axpySse(long long *y, const long long *x, std::size_t n, long long w, long long p) {
+                const __m128i vp = _mm_set1_epi64x(p);
+                const __m128i vw = _mm_set1_epi64x(w);
+                const __m128i vwShoup = _mm_set1_epi64x(static_cast<long long>(shoupConstant32(w, p)));
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    __m128i wx = shoupMulSse(loadSse(x + i), vw, vwShoup, vp);
+                    storeSse(y + i, reduceSse(_mm_add_epi64(loadSse(y + i), wx), vp));
+                }
+                axpyScalar(y + i, x + i, n - i, w, p);
+            }
+
+            __attribute__((target("sse4.1")))
+            long long hornerSse(const long long *a, std::size_t n, long long x, long long p) {
+                const long long x2 = static_cast<long long>(powMod32(x, 2, p));
+                const __m128i vp = _mm_set1_epi64x(p);
+                const __m128i vx2 = _mm_set1_epi64x(x2);
+                const __m128i vx2Shoup = _mm_set1_epi64x(static_cast<long long>(shoupConstant32(x2, p)));
+                // The incomplete block of the highest coefficients is padded with zeros
+                long long lanes[2] = {0, 0};
+                std::size_t blocks = n / 2;
+                for (std::size_t j = 0; j < n % 2; ++j)
+                    lanes[j] = a[2 * blocks + j];
+                __m128i acc = loadSse(lanes);
+                while (blocks-- > 0)
+                    acc = reduceSse(_mm_add_epi64(shoupMulSse(acc, vx2, vx2Shoup, vp), loadSse(a + 2 * blocks)), vp);
+                storeSse(lanes, acc);
+                // sum_j lanes[j]*x^j
+                return hornerScalar(lanes, 2, x, p);
+            }
+
+            // AVX2 kernels, 4 lanes. Same as the SSE4.1 ones
+
+            __attribute__((target("avx2")))
+            inline __m256i reduceAvx2(__m256i r, __m256i p) {
+                return _mm256_min_epu32(r, _mm256_sub_epi64(r, p));
+            }
+
+            __attribute__((target("avx2")))
+            inline __m256i shoupMulAvx2(__m256i a, __m256i w, __m256i wShoup, __m256i p) {
+                __m256i q = _mm256_srli_epi64(_mm256_mul_epu32(a, wShoup), 32);
+                return reduceAvx2(_mm256_sub_epi64(_mm256_mul_epu32(a, w), _mm256_mul_epu32(q, p)), p);
+            }
+
+            __attribute__((target("avx2")))
+            inline __m256i loadAvx2(const long long *a) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+            }
+
+            __attribute__((target("avx2")))
+            inline void storeAvx2(long long *r, __m256i v) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(r), v);
+            }
+
+            __attribute__((target("avx2")))
+            void addAvx2(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+                const __m256i vp = _mm256_set1_epi64x(p);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    storeAvx2(r + i, reduceAvx2(_mm256_add_epi64(loadAvx2(a + i), loadAvx2(b + i)), vp));
+                addScalar(r + i, a + i, b + i, n - i, p);
+            }
+
+            __attribute__((target("avx2")))
+            void subAvx2(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+                const __m256i vp = _mm256_set1_epi64x(p);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i d = _mm256_sub_epi64(loadAvx2(a + i), loadAvx2(b + i));
+                    storeAvx2(r + i, _mm256_min_epu32(d, _mm256_add_epi64(d, vp)));
+                }
+                subScalar(r + i, a + i, b + i, n - i, p);
+            }
+
+            __attribute__((target("avx2")))
+            void negAvx2(long long *r, const long long *a, std::size_t n, long long p) {
+                const __m256i vp = _mm256_set1_epi64x(p);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    storeAvx2(r + i, reduceAvx2(_mm256_sub_epi64(vp, loadAvx2(a + i)), vp));
+                negScalar(r + i, a + i, n - i, p);
+            }
+
+            __attribute__((target("avx2")))
+            void scaleAvx2(long long *r, const long long *a, std::size_t n, long long w, long long p) {
+                const __m256i vp = _mm256_set1_epi64x(p);
+                const __m256i vw = _mm256_set1_epi64x(w);
+                const __m256i vwShoup = _mm256_set1_epi64x(static_cast<long long>(shoupConstant32(w, p)));
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    storeAvx2(r + i, shoupMulAvx2(loadAvx2(a + i), vw, vwShoup, vp));
+                scaleScalar(r + i, a + i, n - i, w, p);
+            }
+
+            __attribute__((target("avx2")))
+            void axpyAvx2(long long *y, const long long *x, std::size_t n, long long w, long long p) {
+                const __m256i vp = _mm256_set1_epi64x(p);
+                const __m256i vw = _mm256_set1_epi64x(w);
+                const __m256i vwShoup = _mm256_set1_epi64x(static_cast<long long>(shoupConstant32(w, p)));
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i wx = shoupMulAvx2(loadAvx2(x + i), vw, vwShoup, vp);
+                    storeAvx2(y + i, reduceAvx2(_mm256_add_epi64(loadAvx2(y + i), wx), vp));
+                }
+                axpyScalar(y + i, x + i, n - i, w, p);
+            }
+
+            __attribute__((target("avx2")))
+            long long hornerAvx2(const long long *a, std::size_t n, long long x, long long p) {
+                const long long x4 = static_cast<long long>(powMod32(x, 4, p));
+                const __m256i vp = _mm256_set1_epi64x(p);
+                const __m256i vx4 = _mm256_set1_epi64x(x4);
+                const __m256i vx4Shoup = _mm256_set1_epi64x(static_cast<long long>(shoupConstant32(x4, p)));
+                long long lanes[4] = {0, 0, 0, 0};
+                std::size_t blocks = n / 4;
+                for (std::size_t j = 0; j < n % 4; ++j)
+                    lanes[j] = a[4 * blocks + j];
+                __m256i acc = loadAvx2(lanes);
+                while (blocks-- > 0)
+                    acc = reduceAvx2(_mm256_add_epi64(shoupMulAvx2(acc, vx4, vx4Shoup, vp), loadAvx2(a + 4 * blocks)), vp);
+                storeAvx2(lanes, acc);
+                return hornerScalar(lanes, 4, x, p);
+            }
+#endif
+
+            struct Kernels {
+                void (*add)(long long *, const long long *, const long long *, std::size_t, long long);
+                void (*sub)(long long *, const long long *, const long long *, std::size_t, long long);
+                void (*neg)(long long *, const long long *, std::size_t, long long);
+                void (*scale)(long long *, const long long *, std::size_t, long long, long long);
+                void (*axpy)(long long *, const long long *, std::size_t, long long, long long);
+                long long (*horner)(const long long *, std::size_t, long long, long long);
+                const char *name;
+            };
+
+            Kernels selectKernels() {
+#if ALCP_SIMD_X86
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx2"))
+                    return {addAvx2, subAvx2, negAvx2, scaleAvx2, axpyAvx2, hornerAvx2, "avx2"};
+                if (__builtin_cpu_supports("sse4.1"))
+                    return {addSse, subSse, negSse, scaleSse, axpySse, hornerSse, "sse4.1"};
+#endif
+                return {addScalar, subScalar, negScalar, scaleScalar, axpyScalar, hornerScalar, "scalar"};
+            }
+
+            const Kernels &kernels() {
+                static const Kernels k = selectKernels();
+                return k;
+            }
+        }
+
+        void add(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+            kernels().add(r, a, b, n, p);
+        }
+
+        void sub(long long *r, const long long *a, const long long *b, std::size_t n, long long p) {
+            kernels().sub(r, a, b, n, p);
+        }
+
+        void neg(long long *r, const long long *a, std::size_t n, long long p) {
+            kernels().neg(r, a, n, p);
+        }
+
+        void scale(long long *r, const long long *a, std::size_t n, long long w, long long p) {
+            kernels().scale(r, a, n, w, p);
+        }
+
+        void axpy(long long *y, const long long *x, std::size_t n, long long w, long long p) {
+            kernels().axpy(y, x, n, w, p);
+        }
+
+        long long horner(const long long *a, std::size_t n, long long x, long long p) {
+            return kernels().horner(a, n, x, p);
+        }
+
+        const char *backend() {
+            return kernels().name;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef __SIMD_KERNELS_HPP
+#define __SIMD_KERNELS_HPP
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+
+namespace alcp {
+    /**
+     * Vectorized arithmetic on arrays of residues modulo a prime p < 2^31
+     *
+     * Description:
+     *  Every kernel works on contiguous arrays of reduced residues, i.e. of
+     *   integers in [0, p), and returns reduced residues. The residues are
+     *   stored in 64-bit words (long long, as in the coefficients of
+     *   Fpxelem_b), so the AVX2 kernels have 4 lanes and the SSE4.1 ones 2.
+     *  There are AVX2, SSE4.1 and portable versions of every kernel. The
+     *   best one supported by the CPU is chosen the first time a kernel is
+     *   called. Defining ALCP_NO_SIMD forces the portable version.
+     *
+     * Theoretical background:
+     *  Since p < 2^31, the sum of two residues fits in 32 bits, and min(r, r - p)
+     *   (with unsigned wrap-around) reduces it without branches. The minimum
+     *   is taken on the 32-bit halves of the word, which gives the right
+     *   result because the upper half of r is zero.
+     *  The products by a fixed w use Shoup's multiplication with 32-bit words
+     *   (see shoupMul), so every lane needs three 32x32->64 multiplications.
+     *  Horner's rule is a chain of dependent operations. With L lanes, lane j
+     *   evaluates the polynomial formed by the coefficients a[kL + j] at x^L,
+     *   and the L results are combined at the end:
+     *      sum_i a[i]x^i = sum_j x^j sum_k a[kL + j](x^L)^k
+     *
+     * Complexity:
+     *  O(n) for every kernel
+     */
+    namespace simd {
+        // The kernels can be used for every modulus p < modulusBound
+        constexpr std::uint64_t modulusBound = std::uint64_t(1) << 31;
+
+        // r[i] = a[i] + b[i] (mod p). r may be equal to a or b
+        void add(long long *r, const long long *a, const long long *b, std::size_t n, long long p);
+
+        // r[i] = a[i] - b[i] (mod p). r may be equal to a or b
+        void sub(long long *r, const long long *a, const long long *b, std::size_t n, long long p);
+
+        // r[i] = -a[i] (mod p). r may be equal to a
+        void neg(long long *r, const long long *a, std::size_t n, long long p);
+
+        // r[i] = w*a[i] (mod p). r may be equal to a
+        void scale(long long *r, const long long *a, std::size_t n, long long w, long long p);
+
+        // y[i] = y[i] + w*x[i] (mod p)
+        void axpy(long long *y, const long long *x, std::size_t n, long long w, long long p);
+
+        // sum_{i<n} a[i]*x^i (mod p)
+        long long horner(const long long *a, std::size_t n, long long x, long long p);
+
+        // Kernels in use: "avx2", "sse4.1" or "scalar"
+        const char *backend();
+    }
+}
+
+#endif // __SIMD_KERNELS_HPP
@@ -0,0 +1,112 @@
+#ifndef __STATIC_FPELEM_HPP
+#define __STATIC_FPELEM_HPP
+
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+#include "exceptions.hpp"
+#include "zelem.hpp"            // to_string
+#include "modArith.hpp"         // StaticModulus, isPrime64
+#include "quotientRing.hpp"
+
+namespace alcp {
+    /**
+     * Finite field F_P with the prime P known at compile time
+     *
+     * Description:
+     *  Same interface as Fp, but the modulus, its reduction constants and
+     *   the compatibility checks are resolved at compile time, and every
+     *   element is just one machine word.
+     *  The elements and the polynomials are the member templates Elem and
+     *   Xelem, so they can be used as FelemBase / FxelemBase in QuotientRing
+     *   and PolynomialRing. They are meant to be instantiated with long long,
+     *   which is what the aliases StaticFpelem<P> and StaticFpxelem<P> do.
+     */
+    template<long long P>
+    class StaticFp {
+    static_assert(isPrime64(P), "The modulus of a StaticFp must be prime.");
+    public:
+        template<class Integer>
+        class Elem : public QuotientRing<StaticFp::template Elem, Integer, Integer, StaticModulus<P>> {
+        private:
+            using FBase = QuotientRing<StaticFp::template Elem, Integer, Integer, StaticModulus<P>>;
+
+        public:
+            using F = StaticFp;
+            using FBase::FBase;
+            using FBase::operator=;
+
+            Elem() = default;
+            Elem(const Elem & e)  = default;
+            Elem(Elem && e)  = default;
+            Elem & operator=(const Elem & e)  = default;
+            Elem & operator=(Elem && e)  = default;
+
+            F getField() const{ return F(); }
+
+            friend std::string to_string(const Elem &e) {
+                return to_string(e._num);
+            }
+
+            friend std::string to_string_coef(const Elem& e){
+                return "+" + to_string(e);
+            }
+
+            // The Frobenius map is the identity on F_p
+            friend Elem frobenius(const Elem &e, std::size_t = 1) { return e; }
+
+            friend Elem pthRoot(const Elem &e) { return e; }
+
+        private:
+            friend class StaticFp;
+        };
+
+        // Defined in staticFpxelem.hpp
+        template<class Integer>
+        class Xelem;
+
+        constexpr StaticFp() = default;
+
+        Elem<long long> get(long long n) const {
+            return Elem<long long>(StaticModulus<P>().reduce(n), StaticModulus<P>());
+        }
+
+        Elem<long long> zero() const { return Elem<long long>(0LL, StaticModulus<P>()); }
+
+        Elem<long long> one() const { return Elem<long long>(1LL, StaticModulus<P>()); }
+
+        constexpr long long mod() const { return P; }
+
+        constexpr long long getSize() const { return P; }
+
+        constexpr long long getP() const { return P; }
+
+        constexpr std::size_t getM() const { return 1; }
+
+        std::vector<Elem<long long>> getElems() const {
+            std::vector<Elem<long long>> ret(static_cast<std::size_t>(P));
+            for (std::size_t i = 0; i < ret.size(); ++i)
+                ret[i] = this->get(static_cast<long long>(i));
+            return ret;
+        }
+
+        constexpr bool operator==(const StaticFp &) const { return true; }
+
+        constexpr bool operator!=(const StaticFp &) const { return false; }
+
+        friend std::string to_string(const StaticFp &) {
+            return "F" + to_string(P);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const StaticFp &e) {
+            os << to_string(e);
+            return os;
+        }
+    };
+
+    template<long long P>
+    using StaticFpelem = typename StaticFp<P>::template Elem<long long>;
+}
+
+#endif // __STATIC_FPELEM_HPP
@@ -0,0 +1,77 @@
+// Implementation of a GF(P)[X] ring with P known at compile time
+#ifndef __STATIC_FPXELEM_HPP
+#define __STATIC_FPXELEM_HPP
+
+#include <vector>
+
+#include "types.hpp"
+#include "generalPurpose.hpp"   // fastPowMod, gcd
+#include "staticFpelem.hpp"
+#include "polRing.hpp"
+
+namespace alcp {
+    template<long long P>
+    template<class Integer>
+    class StaticFp<P>::Xelem : public PolynomialRing<StaticFp<P>::template Xelem, typename StaticFp<P>::template Elem<Integer>, Integer> {
+    private:
+        using FBase = PolynomialRing<StaticFp<P>::template Xelem, typename StaticFp<P>::template Elem<Integer>, Integer>;
+
+    public:
+        // Base field
+        using F = StaticFp<P>;
+        using Felem = typename StaticFp<P>::template Elem<Integer>;
+
+        // Inherit ctors
+        using FBase::FBase;
+
+        Xelem() = default;
+
+        Xelem(const std::vector<Integer> &v) : FBase{
+            [&]() -> Xelem{
+                std::vector<Felem> ret(v.size());
+                for (std::size_t i = 0; i < v.size(); ++i)
+                    ret[i] = F().get(v[i]);
+                return ret;
+            }()} { }
+
+        bool irreducible() const {
+            Xelem x(std::vector<Felem>{getZero(this->lc()), getOne(this->lc())});
+            Xelem xpk = x; // x^(p^k)
+
+            for (std::size_t i = 0; i < this->deg() / 2; ++i) {
+                xpk = fastPowMod(xpk, P, *this);
+                if (gcd(*this, xpk - x).deg() != 0)
+                    return false;
+            }
+            return true;
+        }
+
+        constexpr F getField() const { return F(); }
+
+        constexpr Integer getSize() const { return P; }
+
+        // non-member functions
+        friend Xelem getZero(const Xelem &) { return Xelem(F().zero()); }
+
+        friend Xelem getOne(const Xelem &) { return Xelem(F().one()); }
+
+        friend Xelem unit(const Xelem &e) { return e.lc(); }
+
+        friend constexpr bool compatible(const Xelem &, const Xelem &) { return true; }
+
+        friend bool operator==(const Xelem &lhs, Integer rhs) {
+            return lhs.deg() == 0 && lhs.lc() == F().get(rhs);
+        }
+
+        friend bool operator==(Integer lhs, const Xelem &rhs) { return rhs == lhs; }
+
+        friend bool operator!=(const Xelem &lhs, Integer rhs) { return !(lhs == rhs); }
+
+        friend bool operator!=(Integer lhs, const Xelem &rhs) { return !(rhs == lhs); }
+    };
+
+    template<long long P>
+    using StaticFpxelem = typename StaticFp<P>::template Xelem<long long>;
+}
+
+#endif // __STATIC_FPXELEM_HPP
@@ -2,13 +2,29 @@
 #define __TYPES_HPP
 
 #include <boost/multiprecision/cpp_int.hpp>
+#ifdef ALCP_BIG_INT_GMP
+#include <boost/multiprecision/gmp.hpp>
+#endif
 #include <type_traits>
 
 namespace alcp {
     namespace bmp   = boost::multiprecision;
-    //using big_int   = bmp::number<bmp::cpp_int::backend_type, bmp::et_off>;
+
+    // The backend of big_int is chosen when building, with the CMake
+    //  option ALCP_BIG_INT (long_long by default)
+#if defined(ALCP_BIG_INT_INT128)
+    __extension__ typedef __int128 big_int;
+    constexpr const char *bigIntBackend = "int128";
+#elif defined(ALCP_BIG_INT_CPP_INT)
+    using big_int   = bmp::number<bmp::cpp_int::backend_type, bmp::et_off>;
+    constexpr const char *bigIntBackend = "cpp_int";
+#elif defined(ALCP_BIG_INT_GMP)
+    using big_int   = bmp::number<bmp::gmp_int, bmp::et_off>;
+    constexpr const char *bigIntBackend = "gmp";
+#else
     using big_int = long long int;
-    //using big_int = bmp::int256_t;
+    constexpr const char *bigIntBackend = "long_long";
+#endif
 
 
 
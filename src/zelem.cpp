@@ -1,9 +1,47 @@
 #include "zelem.hpp"
 
+#include <cctype>   // std::isdigit
+#include <istream>
+#include <ostream>
 #include <string>
 
 
 namespace alcp {
+    __extension__ std::string to_string(const __int128& e) {
+        __extension__ unsigned __int128 n = e < 0 ? -static_cast<unsigned __int128>(e) : e;
+        std::string ret;
+        do {
+            ret += static_cast<char>('0' + static_cast<int>(n % 10));
+            n /= 10;
+        } while (n != 0);
+        if (e < 0)
+            ret += '-';
+        return std::string(ret.rbegin(), ret.rend());
+    }
+
+    __extension__ std::ostream& operator<<(std::ostream& os, const __int128& e) {
+        return os << to_string(e);
+    }
+
+    __extension__ std::istream& operator>>(std::istream& is, __int128& e) {
+        std::string digits;
+        is >> std::ws;
+        if (is.peek() == '-' || is.peek() == '+')
+            digits += static_cast<char>(is.get());
+        while (std::isdigit(is.peek()))
+            digits += static_cast<char>(is.get());
+        if (digits.empty() || !std::isdigit(digits.back())) {
+            is.setstate(std::ios::failbit);
+            return is;
+        }
+        __extension__ __int128 n = 0;
+        for (char c : digits)
+            if (std::isdigit(c))
+                n = 10 * n + (c - '0');
+        e = digits[0] == '-' ? -n : n;
+        return is;
+    }
+
 /**
  * Addition of 63 bit numbers without overflow
  */
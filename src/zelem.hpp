@@ -3,6 +3,7 @@
 
 #include <string>
 #include <sstream>
+#include <iosfwd>
 
 #include "types.hpp"
 
@@ -21,46 +22,55 @@ namespace alcp {
 
     // Enable if is base type
     template<class Int>
-    std::enable_if_t<std::is_integral<Int>::value, std::string>
+    std::enable_if_t<std::is_integral<Int>::value && sizeof(Int) <= sizeof(long long), std::string>
     to_string(const Int& e)
     {
         return std::to_string(e);
     }
 
+    // The streams of the standard library do not support __int128
+    __extension__ std::string to_string(const __int128& e);
+
+    __extension__ std::ostream& operator<<(std::ostream& os, const __int128& e);
+
+    __extension__ std::istream& operator>>(std::istream& is, __int128& e);
+
+    // The functions for Z are constrained, so that they are not chosen for
+    //  types that are only convertible to a ring element
     template<class Int>
-    std::string to_string_coef(const Int& e)
+    std::enable_if_t<is_integral<Int>::value, std::string>
+    to_string_coef(const Int& e)
     {
-        static_assert(is_integral<Int>::value, "Type is not a supported integer.");
         return e < 0 ? to_string(e) : "+" + to_string(e);
     }
 
     template<class Int>
-    Int compatible(const Int&, const Int&) {
-        static_assert(is_integral<Int>::value, "Type is not a supported integer.");
+    std::enable_if_t<is_integral<Int>::value, bool>
+    compatible(const Int&, const Int&) {
         return true;
     }
 
     template<class Int>
-    Int unit(const Int& e) {
-        static_assert(is_integral<Int>::value, "Type is not a supported integer.");
+    std::enable_if_t<is_integral<Int>::value, Int>
+    unit(const Int& e) {
         return e >= 0 ? 1 : -1;
     }
 
     template<class Int>
-    Int normalForm(const Int& e) {
-        static_assert(is_integral<Int>::value, "Type is not a supported integer.");
+    std::enable_if_t<is_integral<Int>::value, Int>
+    normalForm(const Int& e) {
         return e / unit<Int>(e);
     }
 
     template<class Int>
-    Int getZero(Int) {
-        static_assert(is_integral<Int>::value, "Type is not a supported integer.");
+    std::enable_if_t<is_integral<Int>::value, Int>
+    getZero(Int) {
         return 0;
     }
 
     template<class Int>
-    Int getOne(Int) {
-        static_assert(is_integral<Int>::value, "Type is not a supported integer.");
+    std::enable_if_t<is_integral<Int>::value, Int>
+    getOne(Int) {
         return 1;
     }
 
@@ -7,6 +7,7 @@
 #include "zelem.hpp"    // Auxliary functions
 #include "fpxelem.hpp"
 #include "polRing.hpp"
+#include "kronecker.hpp"
 
 namespace alcp {
     template<class Integer>
@@ -18,6 +19,16 @@ namespace alcp {
     template<class Integer>
     class Fp;
 
+    template<class Integer>
+    class Zxelem;
+
+    // Measured with coefficients of 20 bits in a long long. It only applies to
+    //  the products that do not use Kronecker substitution, see useKronecker
+    template<>
+    struct KaratsubaThreshold<Zxelem> {
+        static constexpr std::size_t value = 32;
+    };
+
     template<class Integer>
     class Zxelem : public PolynomialRing<Zxelem, Integer, Integer> {
     private:
@@ -26,6 +37,12 @@ namespace alcp {
         using RBase = PolynomialRing<::alcp::Zxelem, Integer, Integer>;
 
     public:
+        // Products where both factors have at least this number of coefficients,
+        //  at least half of them non zero, use Kronecker substitution if the
+        //  largest coefficients of the factors add at least
+        //  KroneckerPacking<Integer>::minBits bits
+        static constexpr std::size_t kroneckerThreshold = 16;
+
         // Inherit ctors
         using RBase::RBase;
 
@@ -37,6 +54,19 @@ namespace alcp {
          * */
         Zxelem(const Fpxelem<Integer> &e) : RBase(toZxelemSym(e)) { }
 
+        using RBase::operator*=;
+
+        Zxelem &operator*=(const Zxelem &rhs) {
+            if (!useKronecker(rhs))
+                return RBase::operator*=(rhs);
+            const std::size_t n = this->_v.size(), m = rhs._v.size();
+            std::vector<Integer> r(n + m - 1);
+            kronecker::mul(r.data(), this->_v.data(), n, this == &rhs ? this->_v.data() : rhs._v.data(), m);
+            this->_v = std::move(r);
+            this->removeTrailingZeros();
+            return *this;
+        }
+
         friend Zxelem<Integer> getZero(const Zxelem<Integer> &e) { return Zxelem<Integer>(0); }
 
         friend Zxelem<Integer> getOne(const Zxelem<Integer> &e) { return Zxelem<Integer>(1); }
@@ -61,6 +91,27 @@ namespace alcp {
                 gcdE = gcd(gcdE, e[i]);
             return gcdE;
         }
+
+    private:
+        bool useKronecker(const Zxelem &rhs) const {
+            constexpr std::size_t minBits = KroneckerPacking<Integer>::minBits;
+            const std::size_t n = this->_v.size(), m = rhs._v.size();
+            if (minBits == kronecker::none || std::min(n, m) < kroneckerThreshold ||
+                2 * this->nonZeroCoefs() < n || 2 * rhs.nonZeroCoefs() < m)
+                return false;
+            return minBits == 0 || this->coefficientBits() + rhs.coefficientBits() >= minBits;
+        }
+
+        // Bits of the largest coefficient in absolute value
+        std::size_t coefficientBits() const {
+            Integer ret = 0;
+            for (const Integer &c : this->_v)
+                if (c > ret)
+                    ret = c;
+                else if (-c > ret)
+                    ret = -c;
+            return kronecker::bits(KroneckerPacking<Integer>::widen(ret));
+        }
     };
 
     using Zxelem_b = Zxelem<big_int>;
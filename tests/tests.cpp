@@ -2,6 +2,14 @@
 
 #include <vector>
 #include <map>
+#include <utility>
+#include <random>
+#include <cstdio>
+#include <string>
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "fpelem.hpp"
 #include "zxelem.hpp"
@@ -10,6 +18,16 @@
 #include "integerCRA.hpp"
 #include "generalPurpose.hpp"
 #include "hensel.hpp"
+#include "staticFpxelem.hpp"
+#include "factorizationFq.hpp"
+#include "berlekampMassey.hpp"
+#include "preparedMultiplier.hpp"
+#include "simdKernels.hpp"
+#include "hybridInt.hpp"
+#include "bchCodes.hpp"
+#include "carrylessMul.hpp"
+#include "f2mxelem.hpp"
+#include "diskCache.hpp"
 
 using namespace alcp;
 
@@ -26,6 +44,1122 @@ TEST(symForm, randomPolynomial){
 }
 
 
+TEST(fpelem, large_prime){
+    // Largest prime below 2^63
+    const big_int p = 9223372036854775783LL;
+    Fp_b f(p);
+    big_int a = p - 2, b = 1234567890123456789LL;
+    __extension__ typedef unsigned __int128 u128;
+    big_int expected = static_cast<long long>(
+            u128(9223372036854775781ULL) * u128(1234567890123456789ULL) % u128(9223372036854775783ULL));
+
+    EXPECT_EQ(static_cast<big_int>(f.get(a) * f.get(b)), expected);
+    EXPECT_EQ(f.get(a) + f.get(b), f.get(b - 2));
+    EXPECT_EQ(f.get(b) - f.get(a), f.get(b + 2));
+    EXPECT_EQ(f.get(b) * f.get(b).inv(), f.get(1));
+    EXPECT_EQ(-f.get(0), f.get(0));
+}
+
+TEST(modulus, generic_wide_prime){
+    __extension__ typedef __int128 i128;
+    // 2^64 - 59 and 2^127 - 1 are prime, and (p-1)^2 does not fit in an __int128
+    for (i128 p : {(i128(1) << 64) - 59, std::numeric_limits<i128>::max()}) {
+        const Modulus<i128> m(p);
+        EXPECT_TRUE(m.mul(p - 1, p - 1) == 1);
+        EXPECT_TRUE(m.mul(p - 2, p - 3) == 6);
+        EXPECT_TRUE(m.add(p - 1, p - 2) == p - 3);
+        EXPECT_TRUE(m.mul(m.inv(12345), 12345) == 1);
+        // Fermat's little theorem
+        EXPECT_TRUE(powMod(i128(3), p - 1, m) == 1);
+    }
+    // The product fits, so it still goes through operator%
+    EXPECT_TRUE(Modulus<i128>(1000003).mul(1000002, 1000002) == 1);
+}
+
+TEST(fpelem, interned_field){
+    Fp_b f(13), g(13), h(11);
+    EXPECT_EQ(f, g);
+    EXPECT_NE(f, h);
+    EXPECT_EQ(f.get(5).getField(), g);
+    EXPECT_TRUE(compatible(f.get(3), g.get(4)));
+    EXPECT_FALSE(compatible(f.get(3), h.get(3)));
+    EXPECT_EQ(getZero(f.get(5)), f.get(13));
+    EXPECT_EQ(getOne(f.get(5)), g.get(14));
+    EXPECT_EQ(sizeof(Fpelem_b), sizeof(std::pair<big_int, void*>));
+    EXPECT_THROW(Fp_b(15), EpNotPrime);
+    // Converting between integer types goes through the context of the same prime
+    const Fpelem<int> small = Fp<int>(13).get(5);
+    const Fpelem<long long> wide = small;
+    EXPECT_EQ(wide, Fp<long long>(13).get(5));
+    EXPECT_EQ(Fpelem<int>(wide * wide), Fp<int>(13).get(12));
+}
+
+TEST(static_fpelem, arithmetic){
+    constexpr long long p = 9223372036854775783LL;
+    StaticFp<p> f;
+    Fp_b g(p);
+    long long a = 4611686018427387904LL, b = 987654321987654321LL;
+
+    static_assert(StaticModulus<p>().mul(2, p - 1) == p - 2, "Compile-time reduction failed.");
+    EXPECT_EQ(sizeof(StaticFpelem<p>), sizeof(long long));
+    EXPECT_EQ(big_int(static_cast<long long>(f.get(a) * f.get(b))), static_cast<big_int>(g.get(a) * g.get(b)));
+    EXPECT_EQ(big_int(static_cast<long long>(f.get(a) - f.get(b))), static_cast<big_int>(g.get(a) - g.get(b)));
+    EXPECT_EQ(big_int(static_cast<long long>(f.get(b).inv())), static_cast<big_int>(g.get(b).inv()));
+    EXPECT_EQ(f.get(3) / f.get(3), getOne(f.get(7)));
+}
+
+TEST(static_fpxelem, factorization){
+    // (x+1)^2 (x^2+1) (x^3+x+1) over F_7
+    StaticFpxelem<7> a({1, 1}), b({1, 0, 1}), c({1, 1, 0, 1});
+    StaticFpxelem<7> pol = a * a * b * c;
+    auto factorsCZ = factorizationCantorZassenhaus(pol);
+    auto factorsB = factorizationBerlekamp(pol);
+    for (auto factors : {factorsCZ, factorsB}) {
+        StaticFpxelem<7> prod = getOne(pol);
+        for (auto &f : factors)
+            prod *= fastPow(f.first, f.second);
+        EXPECT_EQ(prod, pol);
+    }
+}
+
+TEST(static_fpxelem, berlekamp_massey){
+    // s_{i+2} = s_{i+1} + s_i over F_5
+    std::vector<StaticFpelem<5>> s{StaticFp<5>().get(1), StaticFp<5>().get(1)};
+    for (int i = 2; i < 10; ++i)
+        s.push_back(s[i - 1] + s[i - 2]);
+    EXPECT_EQ(berlekampMassey<StaticFpxelem<5>>(s), StaticFpxelem<5>({1, -1, -1}));
+}
+
+TEST(accumulator, lazy_reduction){
+    const big_int p = 9223372036854775783LL;
+    Fp_b f(p);
+    Fpelem_b expected = f.get(5);
+    Accumulator<Fpelem_b> acc(f.get(5));
+    // Enough products close to p^2 to force the sum to be folded
+    for (int i = 1; i <= 100; ++i) {
+        Fpelem_b a = f.get(p - i), b = f.get(p - 3 * i);
+        acc.addProduct(a, b);
+        acc.subProduct(b, b);
+        expected += a * b - b * b;
+    }
+    EXPECT_EQ(acc.get(), expected);
+
+    // Reduction of 128-bit sums, above p^2, without a 128-bit division
+    std::mt19937_64 gen(4);
+    for (std::uint64_t q : {2ULL, 3ULL, 65537ULL, 2147483647ULL, 4611686018427387847ULL, 9223372036854775783ULL}) {
+        const Modulus<long long> mod(static_cast<long long>(q));
+        for (int i = 0; i < 200; ++i) {
+            uint128_t x = (static_cast<uint128_t>(gen()) << 64) | gen();
+            x >>= i % 64;
+            EXPECT_EQ(mod.reduceWide(x), static_cast<std::uint64_t>(x % q));
+        }
+        EXPECT_EQ(mod.reduceWide(~static_cast<uint128_t>(0)), static_cast<std::uint64_t>(~static_cast<uint128_t>(0) % q));
+    }
+    EXPECT_EQ(StaticModulus<1000003>().reduceWide(~static_cast<uint128_t>(0)),
+              static_cast<std::uint64_t>(~static_cast<uint128_t>(0) % 1000003));
+
+    // Every product is a lazy dot product
+    std::vector<Fpelem_b> u, v;
+    for (int i = 0; i < 30; ++i) {
+        u.push_back(f.get(p - 1 - i));
+        v.push_back(f.get(p / 3 + i));
+    }
+    Fpxelem_b a(u), b(v), prod = a * b;
+    for (std::size_t k = 0; k <= prod.deg(); ++k) {
+        Fpelem_b c = f.get(0);
+        for (std::size_t i = 0; i <= k; ++i)
+            if (i < u.size() && k - i < v.size())
+                c += u[i] * v[k - i];
+        EXPECT_EQ(prod[k], c);
+    }
+}
+
+TEST(batch_inversion, fp_fq){
+    Fp_b f(1000003);
+    std::vector<Fpelem_b> v, w;
+    for (int i = 1; i <= 50; ++i)
+        v.push_back(f.get(i * i + 7));
+    w = v;
+    batchInvert(w);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        EXPECT_EQ(w[i], v[i].inv());
+
+    Fq_b fq(3, 4);
+    std::vector<Fqelem_b> u;
+    for (const auto &e : fq.getElems())
+        if (e != fq.zero())
+            u.push_back(e);
+    std::vector<Fqelem_b> uInv(u);
+    batchInvert(uInv);
+    for (std::size_t i = 0; i < u.size(); ++i)
+        EXPECT_EQ(uInv[i] * u[i], fq.get(1));
+}
+
+TEST(prepared_multiplier, shoup){
+    const big_int p = 9223372036854775783LL;
+    Fp_b f(p);
+    for (big_int w : std::vector<big_int>{1, 2, p - 1, p / 3}) {
+        PreparedMultiplier<Fpelem_b> byW(f.get(w));
+        for (big_int a : std::vector<big_int>{0, 1, p - 1, p - 12345, p / 7})
+            EXPECT_EQ(byW.mul(f.get(a)), f.get(a) * f.get(w));
+    }
+
+    StaticFpelem<1000003> u = StaticFp<1000003>().get(999999);
+    PreparedMultiplier<StaticFpelem<1000003>> byU(u);
+    EXPECT_EQ(byU.mul(u), u * u);
+
+    Fpxelem_b pol({f.get(3), f.get(p - 1), f.get(0), f.get(p / 2)});
+    EXPECT_EQ(scale(pol, f.get(p - 5)), Fpxelem_b(f.get(p - 5)) * pol);
+    EXPECT_EQ(scale(pol, f.get(0)), 0);
+
+    std::vector<std::vector<Fpelem_b>> m{{f.get(1), f.get(2)}, {f.get(p - 3), f.get(4)}, {f.get(5), f.get(p - 6)}};
+    std::vector<Fpelem_b> v{f.get(p - 1), f.get(7), f.get(8)};
+    auto vm = PreparedMatrix<Fpelem_b>(m).mulLeft(v);
+    ASSERT_EQ(vm.size(), 2u);
+    for (std::size_t i = 0; i < 2; ++i)
+        EXPECT_EQ(vm[i], v[0] * m[0][i] + v[1] * m[1][i] + v[2] * m[2][i]);
+}
+
+TEST(prepared_multiplier, fq){
+    Fq_b fq(5, 4);
+    auto elems = fq.getElems();
+    for (std::size_t i = 1; i < elems.size(); i += 37) {
+        PreparedMultiplier<Fqelem_b> byW(elems[i]);
+        for (std::size_t j = 0; j < elems.size(); j += 11)
+            EXPECT_EQ(byW.mul(elems[j]), elems[i] * elems[j]);
+    }
+}
+
+TEST(simd_kernels, against_scalar){
+    const long long p = 2147483647;
+    std::mt19937_64 gen(42);
+    for (std::size_t n = 0; n < 35; ++n) {
+        std::vector<long long> a(n), b(n), r(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = static_cast<long long>(gen() % p);
+            b[i] = i % 3 == 0 ? p - 1 : static_cast<long long>(gen() % p);
+        }
+        const long long w = static_cast<long long>(gen() % p);
+        simd::add(r.data(), a.data(), b.data(), n, p);
+        for (std::size_t i = 0; i < n; ++i)
+            EXPECT_EQ(r[i], (a[i] + b[i]) % p);
+        simd::sub(r.data(), a.data(), b.data(), n, p);
+        for (std::size_t i = 0; i < n; ++i)
+            EXPECT_EQ(r[i], (a[i] + p - b[i]) % p);
+        simd::neg(r.data(), a.data(), n, p);
+        for (std::size_t i = 0; i < n; ++i)
+            EXPECT_EQ(r[i], (p - a[i]) % p);
+        simd::scale(r.data(), a.data(), n, w, p);
+        for (std::size_t i = 0; i < n; ++i)
+            EXPECT_EQ(r[i], a[i] * w % p);
+        r = b;
+        simd::axpy(r.data(), a.data(), n, w, p);
+        for (std::size_t i = 0; i < n; ++i)
+            EXPECT_EQ(r[i], (a[i] * w + b[i]) % p);
+        long long h = 0;
+        for (std::size_t i = n; i-- > 0;)
+            h = (h * w + a[i]) % p;
+        EXPECT_EQ(simd::horner(a.data(), n, w, p), h);
+    }
+}
+
+TEST(simd_kernels, fpxelem){
+    Fp_b f(2147483647);
+    std::vector<Fpelem_b> u, v;
+    for (int i = 0; i < 21; ++i) {
+        u.push_back(f.get(2147483647 - 3 * i - 1));
+        v.push_back(f.get(i * 1000003));
+    }
+    Fpxelem_b a(u), b(v);
+    Fpelem_b c = f.get(123456789), x = f.get(987654321);
+    Fpxelem_b sum = a + b, diff = a - b, opp = -a, scaled = c * a;
+    Fpelem_b value = f.get(0);
+    for (std::size_t i = u.size(); i-- > 0;)
+        value = value * x + u[i];
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        EXPECT_EQ(sum[i], u[i] + v[i]);
+        EXPECT_EQ(diff[i], u[i] - v[i]);
+        EXPECT_EQ(opp[i], -u[i]);
+        EXPECT_EQ(scaled[i], c * u[i]);
+    }
+    EXPECT_EQ(a.eval(x), value);
+    EXPECT_EQ(a - a, 0);
+    EXPECT_EQ((a + b).deg(), 20u);
+}
+
+TEST(fp_coefficients, layout){
+    Fp_b f(7);
+    Fpxelem_b a(std::vector<Fpelem_b>{f.get(1), f.get(2), f.get(3)});
+    const Fpxelem_b &ca = a;
+    a[1] = f.get(5);
+    a[2] *= f.get(3);
+    EXPECT_EQ(a, Fpxelem_b(Zxelem_b{{1, 5, 2}}, 7));
+    EXPECT_EQ(ca.lc(), f.get(2));
+    EXPECT_EQ(ca.deg(), 2u);
+    // A single context for all the coefficients, and one word per coefficient
+    EXPECT_EQ(ca[2].getField(), ca[0].getField());
+    EXPECT_EQ(ca.begin()[1], f.get(5));
+    EXPECT_EQ(ca.end() - ca.begin(), 3);
+    std::vector<Fpelem_b> v(ca.begin(), ca.end());
+    EXPECT_EQ(v[1], f.get(5));
+    for (auto &c : a) c += f.get(1);
+    EXPECT_EQ(a, Fpxelem_b(Zxelem_b{{2, 6, 3}}, 7));
+    // As with std::vector, auto copies the coefficient and auto& refers to it
+    auto c = a[0];
+    auto &r = a[0];
+    r = f.get(4);
+    EXPECT_EQ(c, f.get(2));
+    EXPECT_EQ(ca[0], f.get(4));
+    // The residues see the writes through the references
+    const Fpxelem_b sum = a + a;
+    EXPECT_EQ(sum, Fpxelem_b(Zxelem_b{{1, 5, 6}}, 7));
+    r *= f.get(2);
+    EXPECT_EQ(a + a, Fpxelem_b(Zxelem_b{{2, 5, 6}}, 7));
+    Fpelem_b *p = &*a.begin();
+    EXPECT_EQ(*p, f.get(1));
+    a[0] = 2;
+    a[2] = 0;
+    a[1] = 0;
+    EXPECT_EQ(Fpxelem_b(std::vector<Fpelem_b>(ca.begin(), ca.end())).deg(), 0u);
+}
+
+TEST(hybrid_int, promotion){
+    const HybridInt big = HybridInt(std::numeric_limits<long long>::max()) + 1;
+    EXPECT_FALSE(big.isSmall());
+    EXPECT_EQ(to_string(big), "9223372036854775808");
+    EXPECT_EQ(to_string(big * big), "85070591730234615865843651857942052864");
+    EXPECT_TRUE((big - 1).isSmall());
+    EXPECT_EQ(big - 1, std::numeric_limits<long long>::max());
+    EXPECT_EQ(-(-big), big);
+    EXPECT_EQ(big * big / big, big);
+    EXPECT_EQ((big * 3 + 5) % big, 5);
+    EXPECT_TRUE(-big < HybridInt(std::numeric_limits<long long>::min()) + 1);
+}
+
+TEST(hybrid_int, cra_and_gcd){
+    // The product of the moduli does not fit in a long long
+    std::vector<HybridInt> m{2147483647, 2147483629, 2147483587}, u{5, 7, 11};
+    const HybridInt x = integerCRA(m, u);
+    for (std::size_t i = 0; i < m.size(); ++i)
+        EXPECT_EQ((x % m[i] + m[i]) % m[i], u[i]);
+    EXPECT_FALSE(x.isSmall());
+
+    const HybridInt c(HybridInt::Big("100000000000000000000"));
+    Zxelem<HybridInt> g(std::vector<HybridInt>{c, 0, 1});
+    Zxelem<HybridInt> a = g * Zxelem<HybridInt>(std::vector<HybridInt>{1, 1});
+    Zxelem<HybridInt> b = g * Zxelem<HybridInt>(std::vector<HybridInt>{-1, 1});
+    EXPECT_EQ(modularGCD(a, b), g);
+}
+
+TEST(packed_fqelem, residues){
+    // F_{3^2} = F_3[x]/(x^2+1)
+    Fq_b f(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 0, 1}), 3));
+    EXPECT_EQ(f, Fq_b(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 0, 1}), 3)));
+    EXPECT_EQ(f, Fq_b(3, 2));
+    EXPECT_NE(f, Fq_b(Fpxelem_b(Zxelem_b(std::vector<big_int>{2, 1, 1}), 3)));
+    // The residues are stored inline
+    static_assert(sizeof(Fqelem_b) == sizeof(std::pair<FqResidues<big_int>, void *>), "");
+    const Fqelem_b x = f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{0, 1}), 3));
+    EXPECT_EQ(x * x, f.get(2));
+    EXPECT_EQ(x * x * x * x, f.one());
+    EXPECT_EQ(x.inv() * x, f.one());
+    EXPECT_EQ(f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{4, 5, 0, 1}), 3)), f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1}), 3)));
+    // Products agree with the polynomial arithmetic modulo f for every pair of elements
+    const auto elems = f.getElems();
+    ASSERT_EQ(elems.size(), 9u);
+    for (const auto &a : elems)
+        for (const auto &b : elems) {
+            EXPECT_EQ(static_cast<Fpxelem_b>(a * b),
+                      static_cast<Fpxelem_b>(a) * static_cast<Fpxelem_b>(b) % f.mod());
+            EXPECT_EQ(static_cast<Fpxelem_b>(a - b), static_cast<Fpxelem_b>(a) - static_cast<Fpxelem_b>(b));
+        }
+    // Extensions of degree bigger than FqResidues::inlineDegree
+    Fq_b g(2, 11);
+    const Fqelem_b y = g.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 0, 1}), 2));
+    EXPECT_EQ(fastPow(y, g.getSize() - 1), g.one());
+    EXPECT_EQ(y * y.inv(), g.one());
+    // Their residues share the space of the inline ones, and the blocks are reused
+    static_assert(sizeof(FqResidues<long long>) ==
+                  sizeof(std::size_t) + FqResidues<long long>::inlineDegree * sizeof(long long), "");
+    void *block = ResiduePool<big_int>::allocate(11);
+    ResiduePool<big_int>::deallocate(block, 11);
+    EXPECT_EQ(ResiduePool<big_int>::allocate(11), block);
+    ResiduePool<big_int>::deallocate(block, 11);
+    // A polynomial over F_q is one buffer of m words per coefficient
+    Fqxelem_b h(std::vector<Fqelem_b>{x, f.one(), x * x});
+    const Fqxelem_b &ch = h;
+    EXPECT_EQ(ch.deg(), 2u);
+    h[1] += x;
+    for (auto &c : h) c *= x;
+    EXPECT_EQ(ch, Fqxelem_b(std::vector<Fqelem_b>{x * x, x + x * x, x * x * x}));
+    const Fqxelem_b copy = h;
+    EXPECT_EQ(ch * ch, ch * copy);
+    EXPECT_EQ((ch * ch).deg(), 4u);
+}
+
+TEST(zech_fq, against_residues){
+    for (const auto &f : {Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 0, 1}), 3),
+                          Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 0, 0, 1}), 2)}) {
+        Fq_b res(f), zech(f, FqRepresentation::zech);
+        EXPECT_NE(res, zech);
+        EXPECT_EQ(zech.getRepresentation(), FqRepresentation::zech);
+        const auto elemsRes = res.getElems(), elemsZech = zech.getElems();
+        ASSERT_EQ(elemsRes.size(), elemsZech.size());
+        for (std::size_t i = 0; i < elemsRes.size(); ++i) {
+            const auto &a = elemsZech[i];
+            EXPECT_EQ(static_cast<Fpxelem_b>(a), static_cast<Fpxelem_b>(elemsRes[i]));
+            EXPECT_EQ(static_cast<Fpxelem_b>(-a), static_cast<Fpxelem_b>(-elemsRes[i]));
+            if (a != 0) {
+                EXPECT_EQ(a * a.inv(), zech.one());
+            }
+            const PreparedMultiplier<Fqelem_b> byA(a);
+            for (std::size_t j = 0; j < elemsRes.size(); ++j) {
+                const auto &b = elemsZech[j];
+                EXPECT_EQ(static_cast<Fpxelem_b>(a + b), static_cast<Fpxelem_b>(elemsRes[i] + elemsRes[j]));
+                EXPECT_EQ(static_cast<Fpxelem_b>(a - b), static_cast<Fpxelem_b>(elemsRes[i] - elemsRes[j]));
+                EXPECT_EQ(static_cast<Fpxelem_b>(a * b), static_cast<Fpxelem_b>(elemsRes[i] * elemsRes[j]));
+                EXPECT_EQ(byA.mul(b), a * b);
+            }
+        }
+        EXPECT_EQ(zech.get(2) + zech.get(1), zech.get(3));
+    }
+    EXPECT_THROW(Fq_b(2, 21, FqRepresentation::zech), EOperationUnsupported);
+    // 2^64 wraps around to 0 in a long long
+    std::vector<big_int> f64(65, 0);
+    f64[0] = f64[1] = f64[3] = f64[4] = f64[64] = 1;
+    EXPECT_THROW(Fq_b(Fpxelem_b(Zxelem_b(f64), 2), FqRepresentation::zech), EOperationUnsupported);
+    EXPECT_TRUE(FqContext<big_int>::zechAvailable(2, 20));
+    EXPECT_TRUE(FqContext<big_int>::zechAvailable(1000003, 1));
+    EXPECT_FALSE(FqContext<big_int>::zechAvailable(1000003, 2));
+    EXPECT_FALSE(FqContext<big_int>::zechAvailable(2, 64));
+    EXPECT_FALSE(FqContext<big_int>::zechAvailable(2, 163));
+}
+
+TEST(zech_fq, bch_decode){
+    // Example 3 of main: F_{7^2}, l = 48, c = 3, d = 9
+    BCH bch(Fpxelem_b(Zxelem_b(std::vector<big_int>{5, 4, 1}), 7), 1, 48, 3, 9);
+    Fp_b f(7);
+    const Fpxelem_b sent = bch.encode(randomPol(f, bch.getDimension() - 1));
+    Fpxelem_b received = sent;
+    received[3] += f.get(2);
+    received[20] += f.get(5);
+    received[41] += f.get(1);
+    EXPECT_EQ(bch.decode(received), sent);
+}
+
+TEST(bch, error_in_the_leading_coefficient){
+    // l = 15, c = 1, d = 7 over F_2
+    BCH bch(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 0, 0, 1}), 2), 1, 15, 1, 7);
+    const Fpxelem_b sent = bch.getG() * Fpxelem_b(Zxelem_b(std::vector<big_int>{0, 0, 0, 1}), 2);
+    ASSERT_EQ(sent.deg(), 13u);
+    // The error in x^13 cancels the leading coefficient of sent
+    const Fpxelem_b errors(Zxelem_b(std::vector<big_int>{0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1}), 2);
+    EXPECT_EQ(bch.decode(sent + errors), sent);
+}
+
+TEST(f2melem, against_fq){
+    // Carry-less products against the definition
+    std::mt19937_64 gen(7);
+    for (int k = 0; k < 100; ++k) {
+        const std::uint64_t a = gen(), b = gen();
+        std::uint64_t lo = 0, hi = 0;
+        for (int i = 0; i < 64; ++i)
+            if ((b >> i) & 1) {
+                lo ^= a << i;
+                hi ^= i == 0 ? 0 : a >> (64 - i);
+            }
+        const clmul::Wide p = clmul::mul1(a, b);
+        EXPECT_EQ(p.lo, lo);
+        EXPECT_EQ(p.hi, hi);
+    }
+
+    // GF(2^4) with the modulus of the first example of BCH
+    const Fpxelem_b mod(Zxelem_b(std::vector<big_int>{1, 1, 0, 0, 1}), 2);
+    F2m_b f(mod);
+    Fq_b g(mod);
+    EXPECT_EQ(f, F2m_b(mod));
+    EXPECT_EQ(f.getSize(), 16);
+    const auto elemsF = f.getElems();
+    const auto elemsG = g.getElems();
+    ASSERT_EQ(elemsF.size(), elemsG.size());
+    for (std::size_t i = 0; i < elemsF.size(); ++i) {
+        EXPECT_EQ(static_cast<Fpxelem_b>(elemsF[i]), static_cast<Fpxelem_b>(elemsG[i]));
+        if (elemsF[i] != 0) {
+            EXPECT_EQ(static_cast<Fpxelem_b>(elemsF[i].inv()), static_cast<Fpxelem_b>(elemsG[i].inv()));
+        }
+        for (std::size_t j = 0; j < elemsF.size(); ++j) {
+            EXPECT_EQ(static_cast<Fpxelem_b>(elemsF[i] + elemsF[j]), static_cast<Fpxelem_b>(elemsG[i] + elemsG[j]));
+            EXPECT_EQ(static_cast<Fpxelem_b>(elemsF[i] * elemsF[j]), static_cast<Fpxelem_b>(elemsG[i] * elemsG[j]));
+        }
+    }
+
+    // Two words: x^127 + x + 1
+    std::vector<big_int> trinomial(128, 0);
+    trinomial[0] = trinomial[1] = trinomial[127] = 1;
+    const Fpxelem_b big(Zxelem_b(trinomial), 2);
+    F2m_b h(big);
+    Fp_b f2(2);
+    const Fpxelem_b a = randomPol(f2, 126), b = randomPol(f2, 126);
+    EXPECT_EQ(static_cast<Fpxelem_b>(h.get(a) * h.get(b)), a * b % big);
+    if (a != 0) {
+        EXPECT_EQ(h.get(a) * h.get(a).inv(), h.one());
+    }
+
+    // Sizes that overflow a long long: x^127 + x + 1 and x^64 + x^4 + x^3 + x + 1
+    std::vector<big_int> pentanomial(65, 0);
+    pentanomial[0] = pentanomial[1] = pentanomial[3] = pentanomial[4] = pentanomial[64] = 1;
+    for (const F2m_b &field : {h, F2m_b(Fpxelem_b(Zxelem_b(pentanomial), 2))}) {
+        if (powFits(big_int(2), field.getM())) {
+            EXPECT_EQ(field.getSize(), fastPow(big_int(2), field.getM()));
+        }
+        else {
+            EXPECT_THROW(field.getSize(), EOperationUnsupported);
+        }
+        EXPECT_THROW(field.getElems(), EOperationUnsupported);
+    }
+}
+
+TEST(f2melem, polynomials){
+    F2m_b f(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 0, 0, 1}), 2));
+    const F2melem_b t = f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{0, 1}), 2));
+    // (X + t)^2 (X^2 + X + t^3) (X^3 + t X + 1) over GF(2^4)
+    F2mxelem_b a({t, f.one()}), b({t * t * t, f.one(), f.one()}), c({f.one(), t, f.zero(), f.one()});
+    F2mxelem_b pol = a * a * b * c;
+    // g of degree d is irreducible over GF(16) iff g | X^{16^d} - X and
+    //  gcd(X^{16^k} - X, g) = 1 for every proper divisor k of d
+    const F2mxelem_b x({f.zero(), f.one()});
+    auto irreducible = [&](const F2mxelem_b &g) {
+        auto frob = [&](std::size_t k) {
+            F2mxelem_b y = x % g;
+            for (std::size_t i = 0; i < 4 * k; ++i)
+                y = y * y % g;
+            return y - x;
+        };
+        const std::size_t d = g.deg();
+        if (d == 0 || frob(d) % g != 0)
+            return false;
+        for (std::size_t k = 1; k < d; ++k)
+            if (d % k == 0 && gcd(frob(k), g).deg() != 0)
+                return false;
+        return true;
+    };
+    EXPECT_FALSE(irreducible(a * b));
+    for (auto factors : {factorizationCantorZassenhaus(pol), factorizationBerlekamp(pol)}) {
+        F2mxelem_b prod = getOne(pol);
+        for (auto &fac : factors) {
+            if (fac.first.deg() > 0)
+                EXPECT_TRUE(irreducible(fac.first));
+            prod *= fastPow(fac.first, fac.second);
+        }
+        EXPECT_EQ(prod, pol);
+    }
+    // s_{i+2} = t s_{i+1} + s_i
+    std::vector<F2melem_b> s{f.one(), t};
+    for (int i = 2; i < 10; ++i)
+        s.push_back(t * s[i - 1] + s[i - 2]);
+    EXPECT_EQ(berlekampMassey<F2mxelem_b>(s), F2mxelem_b({f.one(), t, f.one()}));
+}
+
+TEST(f2xelem, against_fpxelem){
+    Fp_b f2(2);
+    for (std::size_t d : {5, 70, 200, 1100}) {
+        const Fpxelem_b a = randomPol(f2, d), b = randomPol(f2, d / 2 + 1);
+        const F2xelem pa(a), pb(b);
+        EXPECT_EQ(static_cast<Fpxelem_b>(pa), a);
+        EXPECT_EQ(static_cast<Fpxelem_b>(pa + pb), a + b);
+        EXPECT_EQ(static_cast<Fpxelem_b>(pa * pb), a * b);
+        EXPECT_EQ(static_cast<Fpxelem_b>(pa.square()), a * a);
+        EXPECT_EQ(static_cast<Fpxelem_b>(pa.derivative()), a.derivative());
+        EXPECT_EQ((pa << 67) >> 67, pa);
+        EXPECT_EQ(pa << 67, pa * F2xelem::monomial(67));
+        // Karatsuba is only used for the biggest one. The generic division is slow for it
+        if (d > 200)
+            continue;
+        if (b != 0) {
+            EXPECT_EQ(static_cast<Fpxelem_b>(pa / pb), a / b);
+            EXPECT_EQ(static_cast<Fpxelem_b>(pa % pb), a % b);
+        }
+        EXPECT_EQ(static_cast<Fpxelem_b>(gcd(pa, pb)), gcd(a, b));
+    }
+    EXPECT_TRUE(F2xelem(std::vector<std::uint64_t>{0x3, 0x8000000000000000ULL}).irreducible()); // x^127 + x + 1
+    EXPECT_FALSE(F2xelem(std::vector<std::uint64_t>{0x15}).irreducible());                      // (x^2 + x + 1)^2
+    EXPECT_EQ(to_string(F2xelem(std::vector<std::uint64_t>{0x13})), "x^4+x+1");
+
+    // Unbalanced products, split in blocks of the shorter factor
+    for (std::size_t d : {40, 1100, 3000}) {
+        const Fpxelem_b a = randomPol(f2, d), b = randomPol(f2, 3 * d + 17);
+        EXPECT_EQ(static_cast<Fpxelem_b>(F2xelem(a) * F2xelem(b)), a * b);
+        EXPECT_EQ(F2xelem(b) * F2xelem(a), F2xelem(a) * F2xelem(b));
+    }
+}
+
+TEST(f2xelem, square_free_and_distinct_degree){
+    Fp_b f2(2);
+    const F2xelem x = F2xelem::monomial(1), one(1);
+    // (x^2 + x + 1)^2 (x^3 + x + 1)^6 x^4 (x^4 + x + 1) (x^7 + x + 1)
+    const F2xelem a(std::vector<std::uint64_t>{0x7}), b(std::vector<std::uint64_t>{0xB}),
+            c(std::vector<std::uint64_t>{0x13}), d(std::vector<std::uint64_t>{0x83});
+    const F2xelem pol = a.square() * b.square() * b.square() * b.square() * x.square().square() * c * d;
+    EXPECT_EQ((pol.square()).squareRoot(), pol);
+    const auto squareFree = squareFreeFF(pol);
+    F2xelem prod = one;
+    for (const auto &pair : squareFree) {
+        EXPECT_EQ(gcd(pair.first, pair.first.derivative()), one);
+        for (std::size_t i = 0; i < pair.second; ++i)
+            prod *= pair.first;
+    }
+    EXPECT_EQ(prod, pol);
+    std::map<std::size_t, F2xelem> bySquareFree;
+    for (const auto &pair : squareFree)
+        bySquareFree.insert(std::make_pair(pair.second, pair.first));
+    EXPECT_EQ(bySquareFree.size(), 4u);
+    EXPECT_EQ(bySquareFree.at(1), c * d);
+    EXPECT_EQ(bySquareFree.at(2), a);
+    EXPECT_EQ(bySquareFree.at(4), x);
+    EXPECT_EQ(bySquareFree.at(6), b);
+
+    const auto distinctDegree = partialFactorDD(x * a * b * c * d);
+    const std::vector<std::pair<F2xelem, std::size_t>> expectedDD{{x, 1}, {a, 2}, {b, 3}, {c, 4}, {d, 7}};
+    EXPECT_EQ(distinctDegree, expectedDD);
+
+    // Fpxelem over F_2 goes through F2xelem
+    const Fpxelem_b f = randomPol(f2, 300);
+    Fpxelem_b prodF = getOne(f);
+    for (const auto &pair : squareFreeFF(f / f.lc()))
+        prodF *= fastPow(pair.first, pair.second);
+    EXPECT_EQ(prodF, f / f.lc());
+    std::size_t degrees = 0;
+    for (const auto &pair : factorizationCantorZassenhaus(f))
+        degrees += pair.first.deg() * pair.second;
+    EXPECT_EQ(degrees, f.deg());
+}
+
+TEST(f2melem, bch_decode){
+    // Minimal polynomials against those of Fq
+    const Fpxelem_b primitive(Zxelem_b(std::vector<big_int>{1, 1, 0, 0, 1}), 2);
+    const F2m_b f(primitive);
+    const Fq_b g(primitive);
+    const auto elemsF = f.getElems();
+    const auto elemsG = g.getElems();
+    for (std::size_t i = 0; i < elemsF.size(); ++i)
+        EXPECT_EQ(minpoly(elemsF[i]), minpoly(elemsG[i]));
+
+    // Binary codes are decoded in F2m: l = 15, c = 1, d = 7
+    BCH bch(primitive, 1, 15, 1, 7);
+    EXPECT_EQ(bch.getG(), Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 1, 0, 1, 1, 0, 0, 1, 0, 1}), 2));
+    Fp_b f2(2);
+    const Fpxelem_b sent = bch.encode(randomPol(f2, bch.getDimension() - 1));
+    // sent may have degree less than 13, so the errors are added as a polynomial
+    const Fpxelem_b errors(Zxelem_b(std::vector<big_int>{0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1}), 2);
+    EXPECT_EQ(bch.decode(sent + errors), sent);
+}
+
+TEST(carryless_mul, against_scalar){
+    // The kernel in use (PCLMULQDQ on most x86 CPUs) against the portable one
+    std::mt19937_64 gen(11);
+    for (int k = 0; k < 1000; ++k) {
+        const std::uint64_t a = gen(), b = gen();
+        const clmul::Wide p = clmul::mul1(a, b), q = clmul::mul1Scalar(a, b);
+        EXPECT_EQ(p.lo, q.lo);
+        EXPECT_EQ(p.hi, q.hi);
+    }
+    for (std::size_t n : {1, 2, 3, 7, 16}) {
+        std::vector<std::uint64_t> a(n), b(n), r(2 * n), expected(2 * n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = gen();
+            b[i] = gen();
+        }
+        clmul::mul(r.data(), a.data(), b.data(), n);
+        clmul::mulScalar(expected.data(), a.data(), b.data(), n);
+        EXPECT_EQ(r, expected);
+    }
+}
+
+TEST(factorization_fq, equal_degree_over_f2){
+    // Two cubics, where the trace of F_64 over F_2 would vanish modulo both
+    const Fpxelem_b cubics = Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 0, 1}), 2) *
+                             Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 0, 1, 1}), 2);
+    const auto factors = factorizationCantorZassenhaus(cubics);
+    ASSERT_EQ(factors.size(), 2u);
+    EXPECT_EQ(factors[0].first * factors[1].first, cubics);
+}
+
+TEST(frobenius, cached_matrix){
+    const Fpxelem_b mod(Zxelem_b(std::vector<big_int>{1, 1, 0, 1}), 5);
+    for (auto rep : {FqRepresentation::residues, FqRepresentation::zech}) {
+        Fq_b f(mod, rep);
+        for (const auto &e : f.getElems()) {
+            EXPECT_EQ(frobenius(e), fastPow(e, 5));
+            EXPECT_EQ(frobenius(e, 2), fastPow(e, 25));
+            EXPECT_EQ(frobenius(e, 3), e);
+            EXPECT_EQ(fastPow(pthRoot(e), 5), e);
+        }
+    }
+    Fq_b g(2, 11);
+    const Fqelem_b a = g.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 0, 1, 0, 0, 0, 1}), 2));
+    EXPECT_EQ(frobenius(a, 4), fastPow(a, 16));
+    EXPECT_EQ(pthRoot(a) * pthRoot(a), a);
+    F2m_b h(11);
+    const F2melem_b b = h.get(static_cast<Fpxelem_b>(a));
+    EXPECT_EQ(frobenius(b, 4), fastPow(b, 16));
+    EXPECT_EQ(pthRoot(b) * pthRoot(b), b);
+
+    // Square-free factorization of a p-th power over F_{5^3}
+    Fq_b f(mod);
+    const Fqelem_b t = f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{0, 1}), 5));
+    const Fqxelem_b c({t, f.one()}), pol = fastPow(c, 5) * Fqxelem_b({f.one(), f.zero(), f.one()});
+    Fqxelem_b prod = getOne(pol);
+    for (auto &fac : factorizationCantorZassenhaus(pol))
+        prod *= fastPow(fac.first, fac.second);
+    EXPECT_EQ(prod, pol);
+}
+
+TEST(itoh_tsujii, inverse){
+    // Degrees on both sides of FqContext::itohTsujiiMaxDegree
+    for (std::size_t m : {1, 2, 3, 7, 32, 33}) {
+        Fq_b f(3, m);
+        std::vector<Fqelem_b> v;
+        Fqelem_b a = f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{2, 1, 1}), 3));
+        for (int i = 0; i < 10; ++i, a = a * a + f.one())
+            if (a != 0)
+                v.push_back(a);
+        std::vector<Fqelem_b> w(v);
+        batchInvert(w);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            EXPECT_EQ(v[i] * v[i].inv(), f.one());
+            EXPECT_EQ(w[i], v[i].inv());
+        }
+    }
+    Fq_b g(Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 1, 0, 1}), 5));
+    for (const auto &e : g.getElems())
+        if (e != 0) {
+            EXPECT_EQ(e * e.inv(), g.one());
+        }
+}
+
+TEST(normal_fq, against_residues){
+    // GF(2^10) has a Gaussian normal basis of type 1, GF(2^8) has none of any type
+    const std::vector<std::pair<int, std::size_t>> fields{{2, 8}, {2, 10}, {3, 4}, {5, 3}, {7, 1}};
+    for (const auto &pm : fields) {
+        Fq_b normal(pm.first, pm.second, FqRepresentation::normal);
+        Fq_b residues(normal.mod());
+        EXPECT_EQ(normal.getRepresentation(), FqRepresentation::normal);
+        const auto elems = residues.getElems();
+        for (std::size_t i = 0; i < elems.size(); i += 1 + elems.size() / 50) {
+            const Fqelem_b a = elems[i], b = elems[(7 * i + 3) % elems.size()];
+            const Fqelem_b na = normal.get(static_cast<Fpxelem_b>(a)), nb = normal.get(static_cast<Fpxelem_b>(b));
+            EXPECT_EQ(static_cast<Fpxelem_b>(na), static_cast<Fpxelem_b>(a));
+            EXPECT_EQ(static_cast<Fpxelem_b>(na * nb), static_cast<Fpxelem_b>(a * b));
+            EXPECT_EQ(static_cast<Fpxelem_b>(na - nb), static_cast<Fpxelem_b>(a - b));
+            EXPECT_EQ(static_cast<Fpxelem_b>(frobenius(na, 2)), static_cast<Fpxelem_b>(frobenius(a, 2)));
+            EXPECT_EQ(static_cast<Fpxelem_b>(pthRoot(na)), static_cast<Fpxelem_b>(pthRoot(a)));
+            EXPECT_EQ(static_cast<Fpxelem_b>(PreparedMultiplier<Fqelem_b>(na).mul(nb)), static_cast<Fpxelem_b>(a * b));
+            if (a != 0) {
+                EXPECT_EQ(static_cast<Fpxelem_b>(na.inv()), static_cast<Fpxelem_b>(a.inv()));
+            }
+        }
+    }
+    // Type 1: x is a root of 1 + x + ... + x^10 and lambda has 2m - 1 nonzero entries
+    Fq_b onb(2, 10, FqRepresentation::normal);
+    EXPECT_EQ(onb.mod(), Fpxelem_b(Zxelem_b(std::vector<big_int>(11, 1)), 2));
+    EXPECT_EQ(onb.getNormalComplexity(), 19u);
+
+    const Fqelem_b t = onb.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{0, 1}), 2));
+    const Fqxelem_b pol = fastPow(Fqxelem_b({t, onb.one()}), 2) * Fqxelem_b({t, t, onb.one()});
+    Fqxelem_b prod = getOne(pol);
+    for (auto &fac : factorizationCantorZassenhaus(pol))
+        prod *= fastPow(fac.first, fac.second);
+    EXPECT_EQ(prod, pol);
+}
+
+TEST(fq_functions, trace_norm_minpoly){
+    const Fpxelem_b mod(Zxelem_b(std::vector<big_int>{1, 1, 0, 1}), 5);
+    std::vector<Fq_b> fields{Fq_b(mod), Fq_b(mod, FqRepresentation::zech), Fq_b(5, 3, FqRepresentation::normal),
+                             Fq_b(3, 35)};
+    for (const auto &f : fields) {
+        const std::size_t m = f.getM();
+        const Fp_b fp = f.getBaseField();
+        Fqelem_b e = f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{2, 1, 1}), fp.getSize()));
+        for (int it = 0; it < 20; ++it, e = e * e + f.one()) {
+            Fqelem_b sum = e, prod = e, conj = e;
+            std::size_t d = 1;
+            for (std::size_t i = 1; i < m; ++i) {
+                conj = frobenius(conj);
+                sum += conj;
+                prod *= conj;
+                if (d == i && conj != e)
+                    ++d;
+            }
+            EXPECT_EQ(f.get(static_cast<big_int>(trace(e))), sum);
+            EXPECT_EQ(f.get(static_cast<big_int>(norm(e))), prod);
+            // The minimal polynomial is monic, vanishes at e and has the degree of its orbit
+            const Fpxelem_b mu = minpoly(e);
+            EXPECT_EQ(mu.lc(), fp.one());
+            EXPECT_EQ(mu.deg(), d);
+            Fqelem_b val = f.zero();
+            for (std::size_t i = mu.deg() + 1; i-- > 0;)
+                val = val * e + f.get(static_cast<big_int>(mu[i]));
+            EXPECT_EQ(val, f.zero());
+        }
+    }
+}
+
+TEST(sparse_modulus, weight_and_reduction){
+    // {p, m, biggest weight expected}: GF(2^8) has no irreducible trinomial
+    const std::vector<std::tuple<int, std::size_t, std::size_t>> cases{
+            {2, 8, 5}, {2, 10, 3}, {2, 163, 5}, {3, 2, 2}, {5, 4, 2}, {3, 5, 3}, {101, 7, 3}, {7, 30, 3}};
+    for (const auto &c : cases) {
+        Fq_b f(std::get<0>(c), std::get<1>(c));
+        const Fpxelem_b mod = f.mod();
+        EXPECT_EQ(mod.deg(), std::get<1>(c));
+        EXPECT_LE(mod.nonZeroCoefs(), std::get<2>(c));
+        EXPECT_TRUE(mod.irreducible());
+        EXPECT_EQ(Fq_b(std::get<0>(c), std::get<1>(c)), f);
+        // 2^163 and 7^30 do not fit in a long long
+        if (powFits(big_int(std::get<0>(c)), std::get<1>(c))) {
+            EXPECT_EQ(f.getSize(), fastPow(big_int(std::get<0>(c)), std::get<1>(c)));
+        }
+        else {
+            EXPECT_THROW(f.getSize(), EOperationUnsupported);
+        }
+
+        // Products of polynomials of degree < m, whose reduction uses every tap
+        Fpxelem_b a(Zxelem_b(std::vector<big_int>{3, 1, 4, 1, 5, 9, 2, 6}), std::get<0>(c));
+        Fpxelem_b b(Zxelem_b(std::vector<big_int>{2, 7, 1, 8, 2, 8, 1, 8}), std::get<0>(c));
+        a %= mod;
+        b %= mod;
+        for (int i = 0; i < 8; ++i) {
+            EXPECT_EQ(static_cast<Fpxelem_b>(f.get(a) * f.get(b)), (a * b) % mod);
+            a = (a * b + Fpxelem_b(Zxelem_b(std::vector<big_int>{1}), std::get<0>(c))) % mod;
+        }
+    }
+}
+
+TEST(disk_cache, moduli_frobenius_and_bch){
+    char dir[] = "/tmp/alcp_cache_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    diskCache::setDirectory(dir);
+
+    // Round trip, and an entry of another key is not taken
+    std::vector<std::uint32_t> key, payload;
+    diskCache::put(key, big_int(123456789));
+    diskCache::put(payload, big_int(987654321));
+    diskCache::store("test", key, payload);
+    // The entry is read in place, so it is compared as a vector
+    diskCache::Entry read;
+    auto words = [](const diskCache::Entry &e) { return std::vector<std::uint32_t>(e.begin(), e.end()); };
+    ASSERT_TRUE(diskCache::load("test", key, read));
+    EXPECT_EQ(words(read), payload);
+    big_int n;
+    diskCache::Reader reader(read);
+    EXPECT_TRUE(reader.get(n) && reader.done());
+    EXPECT_EQ(n, 987654321);
+    EXPECT_FALSE(diskCache::load("test", payload, read));
+    // Storing the entry again replaces the file, and the entry read keeps the old one
+    diskCache::store("test", key, key);
+    EXPECT_EQ(words(read), payload);
+    diskCache::Entry moved(std::move(read));
+    EXPECT_EQ(words(moved), payload);
+    ASSERT_TRUE(diskCache::load("test", key, read));
+    EXPECT_EQ(words(read), key);
+
+    // Fq(p, m) stores its modulus and takes a planted one
+    const Fpxelem_b searched = Fq_b(13, 5).mod();
+    Fp_b f13(13);
+    Fpxelem_b planted = searched;
+    do
+        planted[0] += 1;
+    while (planted == searched || planted[0] == 0 || !planted.irreducible());
+    key.clear();
+    payload.clear();
+    diskCache::put(key, big_int(13));
+    diskCache::put(key, std::size_t(5));
+    diskCache::put(key, std::size_t(0));
+    diskCache::putPolynomial(payload, planted);
+    diskCache::store("modulus", key, payload);
+    Fq_b f(13, 5);
+    EXPECT_EQ(f.mod(), planted);
+
+    // A planted modulus that is reducible or not monic is searched again
+    Fpxelem_b reducible = searched;
+    reducible[0] = f13.zero();
+    for (const Fpxelem_b &wrong : {reducible, Fpxelem_b(f13.get(2)) * searched}) {
+        payload.clear();
+        diskCache::putPolynomial(payload, wrong);
+        diskCache::store("modulus", key, payload);
+        EXPECT_EQ(Fq_b(13, 5).mod(), searched);
+    }
+
+    // Only the matrix of e -> e^p of the new field is stored, when the field is built
+    auto frobeniusFiles = [&]() {
+        std::size_t files = 0;
+        DIR *d = opendir(dir);
+        for (dirent *e; d != nullptr && (e = readdir(d)) != nullptr;)
+            if (std::string(e->d_name).compare(0, 9, "frobenius") == 0)
+                ++files;
+        if (d != nullptr)
+            closedir(d);
+        return files;
+    };
+    std::vector<std::uint32_t> frobeniusKey;
+    diskCache::put(frobeniusKey, big_int(13));
+    diskCache::putPolynomial(frobeniusKey, planted);
+    ASSERT_TRUE(diskCache::load("frobenius", frobeniusKey, read));
+    diskCache::Reader entries(read);
+    std::size_t count = 0;
+    for (big_int r; entries.get(r);)
+        ++count;
+    EXPECT_TRUE(entries.done());
+    EXPECT_EQ(count, 25u);
+    const std::size_t files = frobeniusFiles();
+    const Fqelem_b a = f.get(Fpxelem_b(Zxelem_b(std::vector<big_int>{3, 1, 4, 1, 5}), 13));
+    const Fqelem_b fa = frobenius(a, 2);
+    EXPECT_EQ(fa, fastPow(a, 169));
+    EXPECT_EQ(frobenius(a, 4), fastPow(fa, 169));
+    EXPECT_EQ(frobeniusFiles(), files);
+
+    // Entries that are well formed but wrong are computed again and replaced. The fields
+    //  are interned, so the modulus must not be used by other tests
+    Fpxelem_b fresh(Zxelem_b(std::vector<big_int>{1, 4, 5, 1}), 7);
+    while (!fresh.irreducible())
+        fresh[0] += 1;
+    std::vector<std::uint32_t> freshKey, identity, unit;
+    diskCache::put(freshKey, big_int(7));
+    diskCache::putPolynomial(freshKey, fresh);
+    // The identity is not the matrix of e -> e^7, and 1 is not primitive
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            diskCache::put(identity, big_int(i == j ? 1 : 0));
+    diskCache::store("frobenius", freshKey, identity);
+    for (int c : {1, 0, 0})
+        diskCache::put(unit, big_int(c));
+    diskCache::store("primitive", freshKey, unit);
+    const Fq_b residues(fresh), zech(fresh, FqRepresentation::zech);
+    const Fpxelem_b t(Zxelem_b(std::vector<big_int>{1, 1}), 7);
+    for (const Fqelem_b &e : residues.getElems())
+        EXPECT_EQ(frobenius(e), fastPow(e, 7));
+    for (const Fqelem_b &e : zech.getElems())
+        EXPECT_EQ(static_cast<Fpxelem_b>(e * zech.get(t)), static_cast<Fpxelem_b>(e) * t % fresh);
+    ASSERT_TRUE(diskCache::load("frobenius", freshKey, read));
+    EXPECT_NE(words(read), identity);
+    ASSERT_TRUE(diskCache::load("primitive", freshKey, read));
+    EXPECT_NE(words(read), unit);
+
+    // The generator of a BCH code read from the cache
+    const Fpxelem_b primitive(Zxelem_b(std::vector<big_int>{1, 1, 0, 0, 1}), 2);
+    const BCH first(primitive, 1, 15, 1, 5), second(primitive, 1, 15, 1, 5);
+    EXPECT_EQ(first.getG(), second.getG());
+    EXPECT_EQ(second.getG(), Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 0, 0, 0, 1, 0, 1, 1, 1}), 2));
+
+    // A corrupted file is ignored, both in the header and in the last word of the payload
+    DIR *d;
+    for (long offset : {0L, -12L}) {
+        d = opendir(dir);
+        ASSERT_NE(d, nullptr);
+        for (dirent *e; (e = readdir(d)) != nullptr;)
+            if (std::string(e->d_name).compare(0, 3, "bch") == 0) {
+                std::FILE *file = std::fopen((std::string(dir) + "/" + e->d_name).c_str(), "r+b");
+                ASSERT_NE(file, nullptr);
+                std::fseek(file, offset, offset < 0 ? SEEK_END : SEEK_SET);
+                std::fputc('X', file);
+                std::fclose(file);
+            }
+        closedir(d);
+        EXPECT_EQ(BCH(primitive, 1, 15, 1, 5).getG(), first.getG());
+    }
+
+    // A stored generator that does not divide x^15 - 1, or whose degree is 15, is computed again
+    std::vector<std::uint32_t> bchKey;
+    diskCache::putPolynomial(bchKey, primitive);
+    for (std::size_t param : {1, 15, 1, 5})
+        diskCache::put(bchKey, param);
+    std::vector<big_int> x15(16, 0);
+    x15[0] = x15[15] = 1;
+    for (const Fpxelem_b &wrong : {Fpxelem_b(Zxelem_b(std::vector<big_int>{1, 0, 1}), 2), Fpxelem_b(Zxelem_b(x15), 2)}) {
+        payload.clear();
+        diskCache::putPolynomial(payload, wrong);
+        diskCache::store("bch", bchKey, payload);
+        EXPECT_EQ(BCH(primitive, 1, 15, 1, 5).getG(), first.getG());
+        ASSERT_TRUE(diskCache::load("bch", bchKey, read));
+        EXPECT_NE(words(read), payload);
+    }
+
+    d = opendir(dir);
+    ASSERT_NE(d, nullptr);
+    for (dirent *e; (e = readdir(d)) != nullptr;)
+        if (e->d_name[0] != '.')
+            std::remove((std::string(dir) + "/" + e->d_name).c_str());
+    closedir(d);
+    rmdir(dir);
+    diskCache::setDirectory("");
+}
+
+TEST(karatsuba, against_schoolbook){
+    // Balanced and unbalanced sizes, with a small threshold so every case recurses
+    const std::vector<std::pair<std::size_t, std::size_t>> sizes{
+            {1, 1}, {4, 4}, {5, 4}, {7, 3}, {17, 17}, {33, 20}, {64, 9}, {100, 99}, {2, 150}};
+    std::mt19937 gen(21);
+    std::uniform_int_distribution<int> distr(-1000, 1000);
+    auto randomZ = [&](std::size_t n) {
+        std::vector<big_int> v(n);
+        for (auto &coef : v)
+            coef = distr(gen);
+        v.back() = 1;
+        return Zxelem_b(v);
+    };
+    Fp_b fp(1000003);
+    Fq_b fq(7, 3);
+    for (const auto &s : sizes)
+        for (std::size_t threshold : {std::size_t(2), std::size_t(4), std::size_t(13)}) {
+            const Zxelem_b za = randomZ(s.first), zb = randomZ(s.second);
+            EXPECT_EQ(Zxelem_b::mul(za, zb, threshold), Zxelem_b::mul(za, zb, karatsuba::none));
+            const Fpxelem_b pa = randomPol(fp, s.first - 1), pb = randomPol(fp, s.second - 1);
+            EXPECT_EQ(Fpxelem_b::mul(pa, pb, threshold), Fpxelem_b::mul(pa, pb, karatsuba::none));
+            const Fqxelem_b qa = randomPol(fq, s.first - 1), qb = randomPol(fq, s.second - 1);
+            EXPECT_EQ(Fqxelem_b::mul(qa, qb, threshold), Fqxelem_b::mul(qa, qb, karatsuba::none));
+        }
+    // Operator * uses the threshold of the ring
+    const Fpxelem_b a = randomPol(fp, 299), b = randomPol(fp, 199);
+    EXPECT_EQ(a * b, Fpxelem_b::mul(a, b, karatsuba::none));
+}
+
+TEST(ntt, against_karatsuba){
+    // Direct transforms (998244353 = 119 2^23 + 1) and the CRT, with squares and unbalanced factors
+    for (long long p : {998244353LL, 1000003LL, 2305843009213693951LL}) {
+        Fp_b f(p);
+        for (const auto &s : std::vector<std::pair<std::size_t, std::size_t>>{{1500, 1500}, {1100, 2900}, {1024, 1025}}) {
+            const Fpxelem_b a = randomPol(f, s.first - 1), b = randomPol(f, s.second - 1);
+            EXPECT_EQ(a * b, Fpxelem_b::mul(a, b, 32));
+            EXPECT_EQ(a * a, Fpxelem_b::mul(a, a, 32));
+        }
+    }
+    // Coefficients p - 1, the largest product of each coefficient
+    Fp_b f(2305843009213693951LL);
+    const Fpxelem_b a(std::vector<Fpelem_b>(2000, f.get(-1)));
+    EXPECT_EQ(a * a, Fpxelem_b::mul(a, a, 32));
+}
+
+TEST(kronecker, against_schoolbook){
+    // Coefficients of up to 200 bits of both signs, zeros, squares and unbalanced factors
+    std::mt19937_64 gen(23);
+    auto randomCoef = [&](std::size_t bits) {
+        bmp::cpp_int c = 0;
+        for (std::size_t i = 0; i < bits; i += 64)
+            c = (c << 64) + gen();
+        c >>= (bits + 63) / 64 * 64 - bits;
+        return gen() % 5 == 0 ? bmp::cpp_int(0) : gen() % 2 == 0 ? bmp::cpp_int(-c) : c;
+    };
+    for (std::size_t bits : {1, 31, 64, 65, 200})
+        for (const auto &s : std::vector<std::pair<std::size_t, std::size_t>>{{1, 1}, {3, 70}, {40, 40}, {129, 64}}) {
+            std::vector<bmp::cpp_int> a(s.first), b(s.second);
+            for (auto &c : a)
+                c = randomCoef(bits);
+            for (auto &c : b)
+                c = randomCoef(bits);
+            std::vector<bmp::cpp_int> r(a.size() + b.size() - 1), expected(r.size(), 0);
+            for (std::size_t i = 0; i < a.size(); ++i)
+                for (std::size_t j = 0; j < b.size(); ++j)
+                    expected[i + j] += a[i] * b[j];
+            kronecker::mul(r.data(), a.data(), a.size(), b.data(), b.size());
+            EXPECT_EQ(r, expected);
+            const std::vector<bmp::cpp_int> copy(a);
+            std::vector<bmp::cpp_int> square(2 * a.size() - 1), product(square.size());
+            kronecker::mul(square.data(), a.data(), a.size(), a.data(), a.size());
+            kronecker::mul(product.data(), a.data(), a.size(), copy.data(), a.size());
+            EXPECT_EQ(square, product);
+        }
+
+    // Operator * of Zxelem packs the coefficients of more than 64 bits of HybridInt
+    std::vector<HybridInt> a(50), b(60);
+    for (auto &c : a)
+        c = HybridInt(randomCoef(70));
+    for (auto &c : b)
+        c = HybridInt(randomCoef(40));
+    a.back() = b.back() = 1;
+    const Zxelem<HybridInt> za(a), zb(b);
+    EXPECT_EQ(za * zb, Zxelem<HybridInt>::mul(za, zb, karatsuba::none));
+    EXPECT_EQ(za * za, Zxelem<HybridInt>::mul(za, za, karatsuba::none));
+    // a * a reaches the square of kronecker::mul, as a *= a does
+    Zxelem<HybridInt> square = za;
+    square *= square;
+    EXPECT_EQ(za * za, square);
+}
+
+TEST(kronecker, fqxelem_against_schoolbook){
+    // Residues, normal bases (decoded and encoded) and a long product that goes through the NTT
+    for (const Fq_b &f : {Fq_b(1000003, 4), Fq_b(2, 9), Fq_b(5, 6, FqRepresentation::normal), Fq_b(13, 1)})
+        for (const auto &s : std::vector<std::pair<std::size_t, std::size_t>>{{8, 8}, {9, 40}, {33, 17}}) {
+            const Fqxelem_b a = randomPol(f, s.first - 1), b = randomPol(f, s.second - 1);
+            EXPECT_EQ(a * b, Fqxelem_b::mul(a, b, karatsuba::none));
+            EXPECT_EQ(a * a, Fqxelem_b::mul(a, a, karatsuba::none));
+        }
+    Fq_b f(998244353, 3);
+    const Fqxelem_b a = randomPol(f, 99), b = randomPol(f, 79);
+    EXPECT_EQ(a * b, Fqxelem_b::mul(a, b, 8));
+    // A square goes through the square of the NTT
+    Fqxelem_b square = a;
+    square *= square;
+    EXPECT_EQ(square, Fqxelem_b::mul(a, a, 8));
+    EXPECT_EQ(a * a, square);
+}
+
+TEST(newton_division, against_classical){
+    // Small thresholds force every precision of the Newton iteration
+    const std::vector<std::pair<std::size_t, std::size_t>> degrees{{300, 20}, {300, 250}, {99, 50}, {40, 39}, {7, 0}};
+    for (long long p : {998244353LL, 1000003LL}) {
+        Fp_b f(p);
+        for (const auto &d : degrees) {
+            const Fpxelem_b a = randomPol(f, d.first), b = randomPol(f, d.second);
+            const auto expected = Fpxelem_b::div2(a, b, newton::none);
+            EXPECT_EQ(expected.first * b + expected.second, a);
+            for (std::size_t threshold : {std::size_t(1), std::size_t(2), std::size_t(17)})
+                EXPECT_EQ(Fpxelem_b::div2(a, b, threshold), expected);
+        }
+    }
+    for (const Fq_b &f : {Fq_b(1000003, 4), Fq_b(5, 6, FqRepresentation::normal), Fq_b(2, 8, FqRepresentation::zech)})
+        for (const auto &d : degrees) {
+            const Fqxelem_b a = randomPol(f, d.first / 2), b = randomPol(f, d.second / 2);
+            const auto expected = Fqxelem_b::div2(a, b, newton::none);
+            EXPECT_EQ(expected.first * b + expected.second, a);
+            EXPECT_EQ(Fqxelem_b::div2(a, b, 3), expected);
+            // Operators / and % use the threshold of the field
+            EXPECT_EQ(a / b, expected.first);
+            EXPECT_EQ(a % b, expected.second);
+        }
+}
+
+TEST(newton_division, default_thresholds){
+    // Operators / and % reach Newton iteration with the thresholds of the rings
+    const std::size_t t = NewtonDivisionThreshold<Fqxelem>::value;
+    const Fq_b f(2, 8, FqRepresentation::residues);
+    const Fqxelem_b a = randomPol(f, 2 * t + 5), b = randomPol(f, t);
+    const auto expected = Fqxelem_b::div2(a, b, newton::none);
+    EXPECT_EQ(a / b, expected.first);
+    EXPECT_EQ(a % b, expected.second);
+
+    const std::size_t n = Fpxelem_b::nttNewtonThreshold;
+    const Fp_b fp(998244353);
+    const Fpxelem_b c = randomPol(fp, 2 * n + 1), d = randomPol(fp, n);
+    const auto expectedFp = Fpxelem_b::div2(c, d, newton::none);
+    EXPECT_EQ(expectedFp.first * d + expectedFp.second, c);
+    EXPECT_EQ(c / d, expectedFp.first);
+    EXPECT_EQ(c % d, expectedFp.second);
+}
+
+TEST(newton_division, inexact_over_z){
+    // Over Z a polynomial that does not divide the dividend never leaves a zero remainder
+    const Zxelem_b x3(std::vector<big_int>({0, 3})), x2(std::vector<big_int>({0, 2}));
+    EXPECT_NE(x3 % x2, 0);
+    const Zxelem_b a(std::vector<big_int>({1, 0, 3})), b(std::vector<big_int>({1, 2}));
+    const auto qr = a.div2(b);
+    EXPECT_NE(qr.second, 0);
+    EXPECT_EQ(qr.first * b + qr.second, a);
+    EXPECT_NE(Zxelem_b(std::vector<big_int>({3})) % Zxelem_b(std::vector<big_int>({2})), 0);
+    // Exact divisions are unchanged
+    EXPECT_EQ((a * b) / b, a);
+    EXPECT_EQ((a * b) % b, 0);
+}
+
 TEST(moudlarGCD, randomPoly){
     constexpr int n = 3;
     Zxelem_b a[n] = {Zxelem_b(std::vector<big_int>({-360, -171, 145, 25, 1})),
@@ -41,6 +1175,13 @@ TEST(moudlarGCD, randomPoly){
         EXPECT_EQ(res[i], modularGCD(a[i], b[i]));
 }
 
+TEST(moudlarGCD, coefficients_above_one_prime){
+    // The constant coefficient of the gcd needs the images modulo two primes
+    const Zxelem_b g(std::vector<big_int>({3000000019, 0, 1}));
+    const Zxelem_b a = g * Zxelem_b(std::vector<big_int>({1, 1})), b = g * Zxelem_b(std::vector<big_int>({-1, 1}));
+    EXPECT_EQ(modularGCD(a, b), g);
+}
+
 TEST(CRA, randomPoly){
     EXPECT_EQ(integerCRA({99,97,95}, {49,-21,-30}) ,-272300);
 }